@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 18 Oct 2026 2:14:05pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#define CROSSOVER_SMOOTHING_TIME 0.05
+
+//splits the signal into the band that gets processed (mainBand) and the bands that are left alone,
+//using the high pass/low pass knobs as crossover points. FloatType is float or double.
+template <typename FloatType>
+class Crossover {
+public:
+    enum Mode {
+        off,
+        lowPassOnly, //process the lows, leave the highs
+        highPassOnly, //process the highs, leave the lows
+        threeBand //process the mids, leave the lows and highs
+    };
+
+    Crossover() {
+        highPassHigh.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+        highPassHigh2.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+        lowPassLow.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+        lowPassLow2.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+        highPassMid.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+        lowPassMid.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec, float lowPassFreq, float highPassFreq) {
+        highPassHigh.prepare(spec);
+        highPassHigh2.prepare(spec);
+        lowPassLow.prepare(spec);
+        lowPassLow2.prepare(spec);
+        highPassMid.prepare(spec);
+        lowPassMid.prepare(spec);
+
+        maxFreq = static_cast<float>(spec.sampleRate * 0.49);
+
+        lowPass.reset(spec.sampleRate, CROSSOVER_SMOOTHING_TIME);
+        highPass.reset(spec.sampleRate, CROSSOVER_SMOOTHING_TIME);
+        lowPass.setCurrentAndTargetValue(lowPassFreq);
+        highPass.setCurrentAndTargetValue(highPassFreq);
+
+        //forces the coefficients to be computed on the next block
+        coeffMode = off;
+    }
+
+    void reset() {
+        highPassHigh.reset();
+        highPassHigh2.reset();
+        lowPassLow.reset();
+        lowPassLow2.reset();
+        highPassMid.reset();
+        lowPassMid.reset();
+    }
+
+    //call once per block. the cutoffs glide towards the knob values one block at a time,
+    //and the filter coefficients are only recomputed when they actually move.
+    void setFrequencies(float lowPassFreq, float highPassFreq, int numSamples) {
+        if (highPassFreq == 20.0f && lowPassFreq == 20000.0f) {
+            mode = off;
+        }
+        else if (highPassFreq < 21.0f) {
+            mode = lowPassOnly;
+        }
+        else if (lowPassFreq > 19999.0f) {
+            mode = highPassOnly;
+        }
+        else {
+            mode = threeBand;
+        }
+
+        lowPass.setTargetValue(lowPassFreq);
+        highPass.setTargetValue(highPassFreq);
+        float low = fminf(lowPass.skip(numSamples), maxFreq);
+        float high = fminf(highPass.skip(numSamples), maxFreq);
+
+        if (mode == off || (mode == coeffMode && low == coeffLowPass && high == coeffHighPass)) {
+            return;
+        }
+
+        switch (mode) {
+            case lowPassOnly:
+                lowPassLow.setCutoffFrequency(low);
+                highPassHigh.setCutoffFrequency(low);
+                break;
+            case highPassOnly:
+                lowPassLow.setCutoffFrequency(high);
+                highPassHigh.setCutoffFrequency(high);
+                break;
+            case threeBand:
+                lowPassLow.setCutoffFrequency(high);
+                lowPassLow2.setCutoffFrequency(low);
+                highPassHigh.setCutoffFrequency(low);
+                highPassHigh2.setCutoffFrequency(low);
+                highPassMid.setCutoffFrequency(high);
+                lowPassMid.setCutoffFrequency(low);
+                break;
+            default:
+                break;
+        }
+
+        coeffMode = mode;
+        coeffLowPass = low;
+        coeffHighPass = high;
+    }
+
+    Mode getMode() const {
+        return mode;
+    }
+
+    bool isActive() const {
+        return mode != off;
+    }
+
+    //splits a block of one channel, the band to process replaces the input and the sum of the
+    //untouched bands goes to otherBands. the mode is picked once per block, not per sample.
+    void processBlock(int channel, FloatType* samples, FloatType* otherBands, int numSamples) {
+        switch (mode) {
+            case lowPassOnly:
+                for (int i = 0; i < numSamples; i++) {
+                    otherBands[i] = highPassHigh.processSample(channel, samples[i]); //high band
+                    samples[i] = lowPassLow.processSample(channel, samples[i]); //low band
+                }
+                break;
+            case highPassOnly:
+                for (int i = 0; i < numSamples; i++) {
+                    otherBands[i] = lowPassLow.processSample(channel, samples[i]); //low band
+                    samples[i] = highPassHigh.processSample(channel, samples[i]); //high band
+                }
+                break;
+            case threeBand:
+                for (int i = 0; i < numSamples; i++) {
+                    //low band
+                    FloatType otherBand1 = lowPassLow.processSample(channel, samples[i]);
+                    FloatType otherBand3 = highPassHigh2.processSample(channel, otherBand1);
+                    otherBand1 = lowPassLow2.processSample(channel, otherBand1);
+
+                    //mid band
+                    FloatType mainBand = highPassMid.processSample(channel, samples[i]);
+                    //high band
+                    FloatType otherBand2 = highPassHigh.processSample(channel, mainBand);
+
+                    samples[i] = lowPassMid.processSample(channel, mainBand);
+                    otherBands[i] = otherBand1 + otherBand2 + otherBand3;
+                }
+                break;
+            default:
+                std::fill(otherBands, otherBands + numSamples, FloatType(0));
+        }
+    }
+
+private:
+    juce::dsp::LinkwitzRileyFilter<FloatType> highPassHigh;
+    juce::dsp::LinkwitzRileyFilter<FloatType> highPassHigh2;
+    juce::dsp::LinkwitzRileyFilter<FloatType> lowPassLow;
+    juce::dsp::LinkwitzRileyFilter<FloatType> lowPassLow2;
+    juce::dsp::LinkwitzRileyFilter<FloatType> highPassMid;
+    juce::dsp::LinkwitzRileyFilter<FloatType> lowPassMid;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowPass;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> highPass;
+
+    float maxFreq = 20000.0f;
+
+    Mode mode = off;
+
+    //what the coefficients were last computed for
+    Mode coeffMode = off;
+    float coeffLowPass = 0;
+    float coeffHighPass = 0;
+};
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    LoadMeter.h
+    Created: 18 Oct 2026 10:42:15pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//on in debug builds, anything else can turn it on with THICC_LOAD_METER=1 in its preprocessor definitions
+#ifndef THICC_LOAD_METER
+ #if JUCE_DEBUG
+  #define THICC_LOAD_METER 1
+ #else
+  #define THICC_LOAD_METER 0
+ #endif
+#endif
+
+//times every block and the stages inside it against the real-time budget, which is how long the block lasts at the
+//sample rate. the audio thread only ever writes and the editor only ever reads, through relaxed atomics, so neither
+//side waits. when it is compiled out the timers are empty and nothing is read from the clock.
+class LoadMeter {
+public:
+    static constexpr bool isEnabled = THICC_LOAD_METER != 0;
+
+    enum Stage {
+        upsample,
+        bandSplit, //the crossover, and recombining the bands in multirate mode
+        shaping, //drive, the curves and the mix
+        dcBlock,
+        downsample,
+        metering,
+        fastPath, //dry and linear blocks, instead of everything else
+        numStages
+    };
+
+    //every load is a fraction of the real-time budget, so 1 is a block that took as long as it lasts
+    struct Stats {
+        juce::int64 numBlocks = 0;
+        double minLoad = 0;
+        double averageLoad = 0;
+        double p99Load = 0;
+        double maxLoad = 0;
+        std::array<double, numStages> stageLoads {};
+    };
+
+    static const char* getStageName(Stage stage) {
+        static const char* names[numStages] = { "upsample", "band split", "shaping", "dc block", "downsample", "metering", "fast path" };
+        return names[stage];
+    }
+
+    //while the audio thread isn't running
+    void prepare(double sampleRate) {
+        ticksPerSample = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / sampleRate;
+        clear();
+    }
+
+    //any thread, the audio thread starts over at its next block
+    void reset() {
+        isResetPending.store(true, std::memory_order_relaxed);
+    }
+
+    //any thread, a snapshot of everything since the last reset
+    Stats getStats() const {
+        Stats stats;
+        stats.numBlocks = numBlocks.load(std::memory_order_relaxed);
+
+        if (stats.numBlocks == 0) {
+            return stats;
+        }
+
+        double budget = static_cast<double>(budgetTicks.load(std::memory_order_relaxed));
+        stats.minLoad = minLoad.load(std::memory_order_relaxed);
+        stats.maxLoad = maxLoad.load(std::memory_order_relaxed);
+        stats.averageLoad = static_cast<double>(elapsedTicks.load(std::memory_order_relaxed)) / budget;
+
+        for (int stage = 0; stage < numStages; stage++) {
+            stats.stageLoads[stage] = static_cast<double>(stageTicks[stage].load(std::memory_order_relaxed)) / budget;
+        }
+
+        //upper edge of the bin the 99th percentile block falls in
+        juce::int64 count = 0;
+        juce::int64 target = stats.numBlocks - stats.numBlocks / 100;
+
+        for (int bin = 0; bin < numBins; bin++) {
+            count += histogram[bin].load(std::memory_order_relaxed);
+
+            if (count >= target) {
+                stats.p99Load = juce::jmin(stats.maxLoad, smallestLoad * std::pow(binGrowth, bin + 1));
+                break;
+            }
+        }
+
+        return stats;
+    }
+
+    //times the whole block from construction to destruction, audio thread
+    class BlockTimer {
+    public:
+        BlockTimer(LoadMeter& owner, int blockSize) : meter(owner), numSamples(blockSize) {
+            if constexpr (isEnabled) {
+                if (meter.isResetPending.exchange(false, std::memory_order_relaxed)) {
+                    meter.clear();
+                }
+                start = juce::Time::getHighResolutionTicks();
+            }
+        }
+
+        ~BlockTimer() {
+            if constexpr (isEnabled) {
+                meter.addBlock(juce::Time::getHighResolutionTicks() - start, numSamples);
+            }
+        }
+
+    private:
+        LoadMeter& meter;
+        int numSamples;
+        juce::int64 start = 0;
+    };
+
+    //times stages that run one after another, each lap() adds the time since the last one to a stage.
+    //tasks on the worker pool have their own, so offline the stages can add up to more than the block.
+    class StageTimer {
+    public:
+        explicit StageTimer(LoadMeter& owner) : meter(owner) {
+            if constexpr (isEnabled) {
+                last = juce::Time::getHighResolutionTicks();
+            }
+        }
+
+        void lap(Stage stage) {
+            if constexpr (isEnabled) {
+                juce::int64 now = juce::Time::getHighResolutionTicks();
+                meter.stageTicks[stage].fetch_add(now - last, std::memory_order_relaxed);
+                last = now;
+            }
+        }
+
+    private:
+        LoadMeter& meter;
+        juce::int64 last = 0;
+    };
+
+private:
+    //the histogram for the p99 has bins 5% wider than the one before, from 0.01% of the budget to about 26 times it,
+    //so light and heavy loads are both resolved to a few percent of their value
+    static constexpr double smallestLoad = 1.0e-4;
+    static constexpr double binGrowth = 1.05;
+    static constexpr int numBins = 256;
+
+    //audio thread
+    void addBlock(juce::int64 ticks, int numSamples) {
+        juce::int64 budget = static_cast<juce::int64>(ticksPerSample * numSamples);
+        double load = static_cast<double>(ticks) / static_cast<double>(juce::jmax(juce::int64(1), budget));
+        juce::int64 blockCount = numBlocks.load(std::memory_order_relaxed);
+
+        if (blockCount == 0 || load < minLoad.load(std::memory_order_relaxed)) {
+            minLoad.store(load, std::memory_order_relaxed);
+        }
+        if (load > maxLoad.load(std::memory_order_relaxed)) {
+            maxLoad.store(load, std::memory_order_relaxed);
+        }
+
+        int bin = load > smallestLoad ? juce::jmin(numBins - 1, static_cast<int>(std::log(load / smallestLoad) / std::log(binGrowth))) : 0;
+        histogram[bin].fetch_add(1, std::memory_order_relaxed);
+
+        elapsedTicks.fetch_add(ticks, std::memory_order_relaxed);
+        budgetTicks.fetch_add(budget, std::memory_order_relaxed);
+        numBlocks.store(blockCount + 1, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        numBlocks.store(0, std::memory_order_relaxed);
+        elapsedTicks.store(0, std::memory_order_relaxed);
+        budgetTicks.store(0, std::memory_order_relaxed);
+        minLoad.store(0, std::memory_order_relaxed);
+        maxLoad.store(0, std::memory_order_relaxed);
+
+        for (auto& ticks : stageTicks) {
+            ticks.store(0, std::memory_order_relaxed);
+        }
+        for (auto& count : histogram) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    double ticksPerSample = 1;
+
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<juce::int64> elapsedTicks { 0 };
+    std::atomic<juce::int64> budgetTicks { 0 };
+    std::atomic<double> minLoad { 0 };
+    std::atomic<double> maxLoad { 0 };
+    std::array<std::atomic<juce::int64>, numStages> stageTicks {};
+    std::array<std::atomic<juce::int64>, numBins> histogram {};
+
+    std::atomic<bool> isResetPending { false };
+};
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    PeakFrameQueue.h
+    Created: 19 Oct 2026 2:31:08am
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//the peak levels of one stretch of audio, in the units the waveform display draws (dBFS / 18)
+struct PeakFrame {
+    float input;
+    float output;
+};
+
+//single producer, single consumer queue of peak frames. the audio thread pushes and the editor pops on
+//every refresh of the screen, neither side ever waits or allocates. if the editor falls behind the newest frames are dropped.
+class PeakFrameQueue {
+public:
+    static constexpr int capacity = 64;
+
+    //audio thread
+    void push(const PeakFrame& frame) {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 > 0) {
+            frames[start1] = frame;
+            fifo.finishedWrite(1);
+        }
+    }
+
+    //message thread, returns how many frames were copied to dest, oldest first
+    int pop(PeakFrame* dest, int maxFrames) {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxFrames, start1, size1, start2, size2);
+
+        std::copy(frames.begin() + start1, frames.begin() + start1 + size1, dest);
+        std::copy(frames.begin() + start2, frames.begin() + start2 + size2, dest + size1);
+        fifo.finishedRead(size1 + size2);
+
+        return size1 + size2;
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<PeakFrame, capacity> frames {};
+};
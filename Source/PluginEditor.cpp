@@ -20,12 +20,17 @@
 #define WAVEFORM_BAR_COLOR juce::Colour(150, 150, 170)
 #define WAVEFORM_LINE_COLOR juce::Colour(80, 80, 100)
 #define WAVEFORM_RED_COLOR juce::Colour(0.0f, 1.0f, 0.5f, 0.85f)
+#define LOAD_BACKGROUND_COLOR BACKGROUND_COLOR.withAlpha(0.8f)
+
+#define LOAD_UPDATE_TIME 1000 //ms between updates of the load overlay
 
 //==============================================================================
 THICCAudioProcessorEditor::THICCAudioProcessorEditor (THICCAudioProcessor& p, juce::AudioProcessorValueTreeState& vts)
     : AudioProcessorEditor (&p), audioProcessor (p), valueTreeState(vts)
 {
-    Timer::startTimerHz(20);
+    peakHistory.assign(audioProcessor.getVolArraySize(), { -96.0f, -96.0f });
+    audioProcessor.setMeteringEnabled(true);
+
     setResizable(true, true);
     setLookAndFeel(new SliderLook());
 
@@ -117,18 +122,31 @@ THICCAudioProcessorEditor::THICCAudioProcessorEditor (THICCAudioProcessor& p, ju
     clipButton.setClickingTogglesState(true);
     addAndMakeVisible(clipButton);
     clipAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "clip", clipButton));
+    clipButton.onClick = [this] { updateButtonText(); };
 
     peakButton.setClickingTogglesState(true);
     addAndMakeVisible(peakButton);
     peakAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "peak", peakButton));
+    peakButton.onClick = [this] { updateButtonText(); };
 
     evenButton.setClickingTogglesState(true);
     addAndMakeVisible(evenButton);
     evenAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "even", evenButton));
+    evenButton.onClick = [this] { updateButtonText(); };
+
+    updateButtonText();
 
     displayButton.setClickingTogglesState(true);
     addAndMakeVisible(displayButton);
     displayButton.setButtonText("Toggle Display");
+    displayButton.onClick = [this] {
+        renderWaveform();
+        repaint(waveformRect);
+    };
+
+    addAndMakeVisible(optionsButton);
+    optionsButton.setButtonText("Options");
+    optionsButton.onClick = [this] { showOptionsMenu(); };
 
     //combo boxes
     addAndMakeVisible(typeBox);
@@ -150,12 +168,62 @@ THICCAudioProcessorEditor::THICCAudioProcessorEditor (THICCAudioProcessor& p, ju
 THICCAudioProcessorEditor::~THICCAudioProcessorEditor()
 {
     setLookAndFeel(nullptr);
-    Timer::stopTimer();
+    audioProcessor.setMeteringEnabled(false);
 }
 
 //==============================================================================
 void THICCAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    //the caches are drawn at the screen's pixel density, and redrawn if the window moves to a screen with another one
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != imageScale) {
+        imageScale = scale;
+        renderChrome();
+        renderWaveform();
+    }
+
+    g.drawImage(chromeImage, getLocalBounds().toFloat());
+
+    //--------------------------WAVEFORM-----------------------------------
+
+    //the history image has one column per frame in ring order, so it is drawn in two parts, oldest to newest
+    int volArraySize = static_cast<int>(peakHistory.size());
+    float barWidth = waveformRect.getWidth() / static_cast<float>(volArraySize);
+    int oldestColumn = (peakHistoryHead + 1) % volArraySize;
+    int numOlderColumns = volArraySize - oldestColumn;
+    int splitX = waveformRect.getX() + juce::roundToInt(numOlderColumns * barWidth);
+
+    g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+    g.drawImage(waveformImage, waveformRect.getX(), waveformRect.getY(), splitX - waveformRect.getX(), waveformRect.getHeight(),
+        oldestColumn, 0, numOlderColumns, waveformImage.getHeight());
+
+    if (oldestColumn > 0) {
+        g.drawImage(waveformImage, splitX, waveformRect.getY(), waveformRect.getRight() - splitX, waveformRect.getHeight(),
+            0, 0, oldestColumn, waveformImage.getHeight());
+    }
+
+    //load overlay in the top left of the waveform
+    if (isLoadShown) {
+        auto loadRect = waveformRect.reduced(WINDOW_WIDTH_48, WINDOW_HEIGHT_48).withHeight(WINDOW_HEIGHT_24 * 3).withWidth(WINDOW_WIDTH_24 * 10);
+
+        g.setColour(LOAD_BACKGROUND_COLOR);
+        g.fillRect(loadRect);
+        g.setColour(TEXT_COLOR);
+        g.setFont(12.0f);
+        g.drawFittedText(loadText, loadRect.reduced(4, 2), juce::Justification::topLeft, 3);
+    }
+
+    g.setColour(SLIDER_THUMB_COLOR);
+    g.drawRect(waveformRect, 2);
+}
+
+//draws everything that only changes with the window size into chromeImage
+void THICCAudioProcessorEditor::renderChrome()
+{
+    chromeImage = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * imageScale)), juce::jmax(1, juce::roundToInt(getHeight() * imageScale)), false);
+
+    juce::Graphics g(chromeImage);
+    g.addTransform(juce::AffineTransform::scale(imageScale));
 
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll(BACKGROUND_COLOR);
@@ -212,65 +280,67 @@ void THICCAudioProcessorEditor::paint (juce::Graphics& g)
     g.drawFittedText("-9", 0, WINDOW_HEIGHT_24 * 11 - 10, 21, 20, juce::Justification::centred, 1);
     g.drawFittedText("-12", 0, WINDOW_HEIGHT_24 * 14 - 10, 21, 20, juce::Justification::centred, 1);
     g.drawFittedText("-15", 0, WINDOW_HEIGHT_24 * 17 - 10, 21, 20, juce::Justification::centred, 1);
+}
 
+//redraws every column of the history, for a new size or display mode
+void THICCAudioProcessorEditor::renderWaveform()
+{
+    int volArraySize = static_cast<int>(peakHistory.size());
+    waveformImage = juce::Image(juce::Image::RGB, volArraySize, juce::jmax(1, juce::roundToInt(waveformRect.getHeight() * imageScale)), false);
 
-    //----------------------------BUTTONS----------------------
-
-    clipButton.setButtonText(clipButton.getToggleState() ? "Clip Mode" : "Saturation Mode");
-    peakButton.setButtonText(peakButton.getToggleState() ? "Hard Clip Peaks" : "Leave Peaks");
-    if (clipButton.getToggleState()) {
-        evenButton.setButtonText(evenButton.getToggleState() ? "Even Harmonics" : "Odd Harmonics");
-    }
-    else {
-        evenButton.setButtonText(evenButton.getToggleState() ? "Warm Saturation" : "Tube Saturation");
+    juce::Graphics g(waveformImage);
+    for (int column = 0; column < volArraySize; column++) {
+        renderWaveformColumn(g, column);
     }
+}
 
-    //--------------------------WAVEFORM-----------------------------------
-    
-    int volArraySize = audioProcessor.getVolArraySize();
-    float barWidth = waveformRect.getWidth() / static_cast<float>(volArraySize);
-    float* inputPeakArr = audioProcessor.getInputPeakArr();
-    float* outputPeakArr = audioProcessor.getOutputPeakArr();
+//draws one frame of the history into its column of waveformImage
+void THICCAudioProcessorEditor::renderWaveformColumn(juce::Graphics& g, int column)
+{
+    const PeakFrame& frame = peakHistory[column];
+    float x = static_cast<float>(column);
+    float height = static_cast<float>(waveformImage.getHeight());
 
     g.setColour(WAVEFORM_BACKGROUND_COLOR);
-    g.fillRect(waveformRect);
+    g.fillRect(x, 0.0f, 1.0f, height);
 
+    //grid lines, placed in window coordinates like the db scale
     g.setColour(WAVEFORM_LINE_COLOR);
+    for (int line : { 3, 4, 5, 8 }) { //-2db, -4db, -6db, -12db
+        float y = std::floor((WINDOW_HEIGHT_24 * line - waveformRect.getY()) * imageScale);
+        g.fillRect(x, y, 1.0f, imageScale);
+    }
 
-    float lineLeft = static_cast<float>(waveformRect.getX());
-    float lineRight = static_cast<float>(waveformRect.getRight());
-
-    g.drawHorizontalLine(WINDOW_HEIGHT_24 * 3, lineLeft, lineRight); //-2db
-    g.drawHorizontalLine(WINDOW_HEIGHT_24 * 4, lineLeft, lineRight); //-4db
-    g.drawHorizontalLine(WINDOW_HEIGHT_24 * 5, lineLeft, lineRight); //-6db
-    g.drawHorizontalLine(WINDOW_HEIGHT_24 * 8, lineLeft, lineRight); //-12db
-
-    
     g.setColour(WAVEFORM_BAR_COLOR);
-    for (int i = 0; i < volArraySize; i++) {
-        float output = fminf(fmaxf(outputPeakArr[i], -1) + 1, 1);
-        g.fillRect(waveformRect.getX() + (volArraySize - i - 1) * barWidth, waveformRect.getY() + waveformRect.getHeight() * (1 - output), barWidth, waveformRect.getHeight() * output);
-    }
+    float output = fminf(fmaxf(frame.output, -1) + 1, 1);
+    g.fillRect(x, height * (1 - output), 1.0f, height * output);
 
     g.setColour(WAVEFORM_RED_COLOR);
-    for (int i = 0; i < volArraySize; i++) {
-        if (displayButton.getToggleState()) {
-            if (inputPeakArr[i] > outputPeakArr[i]) {
-                float output = fminf(inputPeakArr[i] - outputPeakArr[i], 1);
-                g.fillRect(waveformRect.getX() + (volArraySize - i - 1) * barWidth, static_cast<float>(waveformRect.getY()), barWidth, waveformRect.getHeight() * output);
-            }
+    if (displayButton.getToggleState()) {
+        if (frame.input > frame.output) {
+            float difference = fminf(frame.input - frame.output, 1);
+            g.fillRect(x, 0.0f, 1.0f, height * difference);
         }
-        else {
-            float input = fminf(fmaxf(inputPeakArr[i], -1) + 1, 1);
-            float output = fminf(fmaxf(outputPeakArr[i], -1) + 1, 1);
-            if (input > output) {
-                g.fillRect(waveformRect.getX() + (volArraySize - i - 1) * barWidth, waveformRect.getY() + waveformRect.getHeight() * (1 - input), barWidth, waveformRect.getHeight() * (input - output));
-            }
+    }
+    else {
+        float input = fminf(fmaxf(frame.input, -1) + 1, 1);
+        if (input > output) {
+            g.fillRect(x, height * (1 - input), 1.0f, height * (input - output));
         }
     }
+}
 
-    g.setColour(SLIDER_THUMB_COLOR);
-    g.drawRect(waveformRect, 2);
+//button labels follow the parameter values, set when they change instead of on every paint
+void THICCAudioProcessorEditor::updateButtonText()
+{
+    clipButton.setButtonText(clipButton.getToggleState() ? "Clip Mode" : "Saturation Mode");
+    peakButton.setButtonText(peakButton.getToggleState() ? "Hard Clip Peaks" : "Leave Peaks");
+    if (clipButton.getToggleState()) {
+        evenButton.setButtonText(evenButton.getToggleState() ? "Even Harmonics" : "Odd Harmonics");
+    }
+    else {
+        evenButton.setButtonText(evenButton.getToggleState() ? "Warm Saturation" : "Tube Saturation");
+    }
 }
 
 void THICCAudioProcessorEditor::resized()
@@ -306,13 +376,118 @@ void THICCAudioProcessorEditor::resized()
     evenButton.setBounds(WINDOW_WIDTH_24 * 13, WINDOW_HEIGHT_48 * 43, WINDOW_WIDTH_24 * 2, WINDOW_HEIGHT_24 * 2);
 
     displayButton.setBounds(waveformRect.getX() + WINDOW_HEIGHT_48, waveformRect.getBottom() - WINDOW_HEIGHT_24 * 2, WINDOW_WIDTH_24 * 3, WINDOW_HEIGHT_48 * 3);
+    optionsButton.setBounds(waveformRect.getRight() - WINDOW_HEIGHT_48 - WINDOW_WIDTH_24 * 2, waveformRect.getBottom() - WINDOW_HEIGHT_24 * 2, WINDOW_WIDTH_24 * 2, WINDOW_HEIGHT_48 * 3);
 
     //combo box
     typeBox.setBounds(WINDOW_WIDTH_24 * 9, WINDOW_HEIGHT_48 * 43, WINDOW_WIDTH_24 * 2, WINDOW_HEIGHT_24 * 2);
     OSFactorBox.setBounds(WINDOW_WIDTH_24 * 12, TOP_BUTTON_Y, WINDOW_WIDTH_24 * 3, WINDOW_HEIGHT_48 * 3);
+
+    renderChrome();
+    renderWaveform();
 }
 
-void THICCAudioProcessorEditor::timerCallback()
+void THICCAudioProcessorEditor::onVBlank()
 {
+    //the overlay shows the load over the last second, the meter starts over each time it is read
+    juce::uint32 now = juce::Time::getMillisecondCounter();
+    if (isLoadShown && now - lastLoadUpdate >= LOAD_UPDATE_TIME) {
+        lastLoadUpdate = now;
+        updateLoadText();
+        repaint(waveformRect);
+    }
+
+    //moves the peak frames the audio thread has pushed since the last refresh into the history
+    PeakFrame newFrames[PeakFrameQueue::capacity];
+    int numNewFrames = audioProcessor.getPeakFrameQueue().pop(newFrames, PeakFrameQueue::capacity);
+
+    //nothing new, nothing to draw
+    if (numNewFrames == 0) {
+        return;
+    }
+
+    juce::Graphics g(waveformImage);
+    for (int i = 0; i < numNewFrames; i++) {
+        peakHistoryHead = (peakHistoryHead + 1) % static_cast<int>(peakHistory.size());
+        peakHistory[peakHistoryHead] = newFrames[i];
+        renderWaveformColumn(g, peakHistoryHead);
+    }
+
     repaint(waveformRect);
+}
+
+//pops up the settings that don't need a control of their own
+void THICCAudioProcessorEditor::showOptionsMenu()
+{
+    juce::PopupMenu menu;
+
+    addParameterToggle(menu, "multirate", "Multirate Filters");
+    addParameterToggle(menu, "eco", "Eco Quality (faster curves)");
+    addParameterToggle(menu, "linearPhase", "Linear Phase Oversampling");
+    addParameterToggle(menu, "antialiasing", "Antiderivative Antialiasing (for 1x/2x)");
+
+    //presets change in the next block, the knobs follow once the processor has updated the parameters
+    juce::PopupMenu presetMenu;
+    PresetBank& presetBank = audioProcessor.getPresetBank();
+
+    for (int preset = 0; preset < presetBank.getNumPresets(); preset++) {
+        presetMenu.addItem(presetBank.getName(preset), true, preset == audioProcessor.getCurrentProgram(), [this, preset] {
+            audioProcessor.recallPreset(preset);
+        });
+    }
+
+    presetMenu.addSeparator();
+    presetMenu.addItem("Store Current Settings", presetBank.getNumPresets() < PresetBank::maxPresets, false, [this] {
+        audioProcessor.storePreset("Preset " + juce::String(audioProcessor.getPresetBank().getNumPresets() + 1));
+    });
+
+    menu.addSeparator();
+    menu.addSubMenu("Presets", presetMenu);
+
+    if (LoadMeter::isEnabled) {
+        menu.addSeparator();
+        menu.addItem("Show DSP Load", true, isLoadShown, [this] {
+            isLoadShown = !isLoadShown;
+            lastLoadUpdate = juce::Time::getMillisecondCounter();
+            loadText = "Measuring...";
+            audioProcessor.getLoadMeter().reset();
+            repaint(waveformRect);
+        });
+    }
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&optionsButton));
+}
+
+//adds a ticked menu item that flips a bool parameter
+void THICCAudioProcessorEditor::addParameterToggle(juce::PopupMenu& menu, const juce::String& parameterID, const juce::String& text)
+{
+    auto* parameter = valueTreeState.getParameter(parameterID);
+    bool isOn = parameter->getValue() > 0.5f;
+
+    menu.addItem(text, true, isOn, [parameter, isOn] {
+        parameter->beginChangeGesture();
+        parameter->setValueNotifyingHost(isOn ? 0.0f : 1.0f);
+        parameter->endChangeGesture();
+    });
+}
+
+//formats what the load meter has measured since it was last read, as percentages of the real-time budget
+void THICCAudioProcessorEditor::updateLoadText()
+{
+    auto& loadMeter = audioProcessor.getLoadMeter();
+    LoadMeter::Stats stats = loadMeter.getStats();
+    loadMeter.reset();
+
+    if (stats.numBlocks == 0) {
+        loadText = "DSP load: no audio";
+        return;
+    }
+
+    auto percent = [](double load) { return juce::String(load * 100.0, 1) + "%"; };
+
+    loadText = "DSP load  min " + percent(stats.minLoad) + "  avg " + percent(stats.averageLoad)
+        + "  p99 " + percent(stats.p99Load) + "  max " + percent(stats.maxLoad);
+
+    for (int stage = 0; stage < LoadMeter::numStages; stage++) {
+        loadText << (stage % 3 == 0 ? "\n" : "  ") << LoadMeter::getStageName(static_cast<LoadMeter::Stage>(stage)) << " " << percent(stats.stageLoads[stage]);
+    }
 }
\ No newline at end of file
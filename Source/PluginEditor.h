@@ -14,7 +14,7 @@
 //==============================================================================
 /**
 */
-class THICCAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Timer
+class THICCAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
     THICCAudioProcessorEditor (THICCAudioProcessor&, juce::AudioProcessorValueTreeState&);
@@ -23,7 +23,6 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
 
 private:
     // This reference is provided as a quick way for your editor to
@@ -52,6 +51,8 @@ private:
 
     juce::TextButton displayButton;
 
+    juce::TextButton optionsButton;
+
     //combo boxes
     juce::ComboBox typeBox;
     juce::ComboBox OSFactorBox;
@@ -80,11 +81,42 @@ private:
     //waveform vars
     juce::Rectangle<int> waveformRect;
 
+    //the last getVolArraySize() peak frames, a ring with the newest at peakHistoryHead
+    std::vector<PeakFrame> peakHistory;
+    int peakHistoryHead = 0;
+
+    //cached drawing, the chrome only changes with the window size and the history only gains a column per frame
+    juce::Image chromeImage;
+    juce::Image waveformImage; //one column per frame, in the same ring order as peakHistory
+    float imageScale = 1.0f; //physical pixels per window pixel the images were drawn at
+
+    void renderChrome();
+    void renderWaveform();
+    void renderWaveformColumn(juce::Graphics& g, int column);
+    void updateButtonText();
+
+    //once per refresh of the screen the editor is on, and not at all while it is hidden
+    void onVBlank();
+
+    //dsp load overlay over the waveform, only offered when the processor is built with the load meter
+    bool isLoadShown = false;
+    juce::uint32 lastLoadUpdate = 0; //ms counter when the overlay text was last updated
+    juce::String loadText;
+
+    void updateLoadText();
+
+    //options menu
+    void showOptionsMenu();
+    void addParameterToggle(juce::PopupMenu& menu, const juce::String& parameterID, const juce::String& text);
+
     //window sizes
     int WINDOW_HEIGHT_24;
     int WINDOW_HEIGHT_48;
     int WINDOW_WIDTH_24;
     int WINDOW_WIDTH_48;
 
+    //declared last, so it stops before anything it draws is destroyed
+    juce::VBlankAttachment vBlankAttachment { this, [this] { onVBlank(); } };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (THICCAudioProcessorEditor)
 };
@@ -13,7 +13,290 @@
 //constants
 #define VOL_ARRAY_SIZE 256
 #define BIAS 0.4f
-#define DC_BLOCK_COEFF 0.9995f
+#define DC_BLOCK_COEFF 0.9995 //at DC_BLOCK_RATE, about 3.5 Hz
+#define DC_BLOCK_RATE 44100.0 //the coefficient is scaled from this rate to keep the same cutoff at any rate
+#define SMOOTHING_TIME 0.05
+#define OS_FADE_TIME 0.02
+#define WARM_UP_TIME 0.005 //seconds of input the chain runs over before taking back over from the fast path, on top of twice its latency
+#define WARM_UP_SPEED 2 //blocks of that input the chain runs over per block while it catches up, as much as a factor switch costs
+#define SILENCE_THRESHOLD 0.00003f //-90.4575749 dBFS
+#define LINEAR_TOLERANCE 0.00003 //how far from a straight line the curves can be at the output for the fast path, the same -90 dBFS
+#define LINEAR_PROBE_STEP 0.001 //either side of 0, for the slope of the drive section there
+#define ADAA_TOLERANCE 1.0e-5 //steps smaller than this use the curve at the midpoint
+#define STATE_MAGIC 0x43434854 //"THCC"
+#define STATE_VERSION 1
+
+//block stages, each one is a single loop over a contiguous buffer of samples or SIMD registers.
+//SampleType is float, double, or a register of either, ramps hold one value per sample.
+template <typename SampleType, typename Function>
+static void mapStage(SampleType* samples, int numSamples, Function&& function) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = function(samples[i]);
+    }
+}
+
+template <typename SampleType, typename FloatType>
+static void gainStage(SampleType* samples, const FloatType* ramp, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = samples[i] * ramp[i];
+    }
+}
+
+template <typename SampleType, typename FloatType>
+static void mixStage(SampleType* samples, const SampleType* dry, const FloatType* ramp, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = samples[i] * ramp[i] + dry[i] * (1 - ramp[i]);
+    }
+}
+
+template <typename SampleType>
+static void addStage(SampleType* samples, const SampleType* other, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = samples[i] + other[i];
+    }
+}
+
+template <typename SampleType>
+static void peakStage(const SampleType* samples, int numSamples, SampleType& peak) {
+    for (int i = 0; i < numSamples; i++) {
+        peak = SIMDHelpers::max(peak, SIMDHelpers::abs(samples[i]));
+    }
+}
+
+//the dc blocker carries state from sample to sample, so this one stays serial
+template <typename SampleType>
+static void dcBlockStage(SampleType* samples, int numSamples, SIMDHelpers::ElementType<SampleType> coefficient, SampleType& dcIn, SampleType& dcOut) {
+    for (int i = 0; i < numSamples; i++) {
+        dcOut = samples[i] - dcIn + dcOut * coefficient;
+        dcIn = samples[i];
+        samples[i] = dcOut;
+    }
+}
+
+//gain going from start to end over the block
+template <typename FloatType>
+static void rampStage(FloatType* samples, int numSamples, FloatType start, FloatType end) {
+    FloatType step = (end - start) / numSamples;
+
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] *= start + step * (i + 1);
+    }
+}
+
+//delays a block by delay samples. line holds the last length samples before the block, oldest first, with room for
+//a block after them. length is at least delay.
+template <typename FloatType>
+static void delayStage(FloatType* samples, int numSamples, FloatType* line, int length, int delay) {
+    std::copy(samples, samples + numSamples, line + length);
+    std::copy(line + length - delay, line + length - delay + numSamples, samples);
+    std::copy(line + numSamples, line + numSamples + length, line);
+}
+
+//keeps the line of delayStage up to date with a block, without delaying it
+template <typename FloatType>
+static void pushDelayStage(const FloatType* samples, int numSamples, FloatType* line, int length) {
+    if (numSamples >= length) {
+        std::copy(samples + numSamples - length, samples + numSamples, line);
+    }
+    else {
+        std::copy(line + numSamples, line + length, line);
+        std::copy(samples, samples + numSamples, line + length - numSamples);
+    }
+}
+
+//first order antiderivative antialiasing, each output is the mean of the curve between the previous input and this one,
+//(F(x) - F(previous)) / (x - previous). integral is F, worked out once per sample, and function is the curve itself
+//for steps too small to divide by. this delays the signal by half a sample.
+template <typename FloatType, typename Function, typename Integral>
+static void antialiasedStage(FloatType* samples, int numSamples, FloatType& previous, Function&& function, Integral&& integral) {
+    double lastInput = previous;
+    double lastIntegral = integral(lastInput);
+
+    for (int i = 0; i < numSamples; i++) {
+        double input = samples[i];
+        double inputIntegral = integral(input);
+        double step = input - lastInput;
+
+        samples[i] = static_cast<FloatType>(std::abs(step) < ADAA_TOLERANCE ? function((input + lastInput) / 2) : (inputIntegral - lastIntegral) / step);
+
+        lastInput = input;
+        lastIntegral = inputIntegral;
+    }
+    previous = static_cast<FloatType>(lastInput);
+}
+
+//the integrals only exist per value, so a register is done one lane at a time
+template <typename FloatType, typename Function, typename Integral>
+static void antialiasedStage(SIMDHelpers::Register<FloatType>* samples, int numSamples, SIMDHelpers::Register<FloatType>& previous, Function&& function, Integral&& integral) {
+    for (size_t lane = 0; lane < SIMDHelpers::Register<FloatType>::size(); lane++) {
+        double lastInput = previous.get(lane);
+        double lastIntegral = integral(lastInput);
+
+        for (int i = 0; i < numSamples; i++) {
+            double input = samples[i].get(lane);
+            double inputIntegral = integral(input);
+            double step = input - lastInput;
+
+            samples[i].set(lane, static_cast<FloatType>(std::abs(step) < ADAA_TOLERANCE ? function((input + lastInput) / 2) : (inputIntegral - lastIntegral) / step));
+
+            lastInput = input;
+            lastIntegral = inputIntegral;
+        }
+        previous.set(lane, static_cast<FloatType>(lastInput));
+    }
+}
+
+//the same half sample delay, which is all antialiasing does on the straight part of a curve. keeps the dry signal
+//and the other bands lined up with the antialiased band
+template <typename SampleType>
+static void halfSampleStage(SampleType* samples, int numSamples, SampleType& previous) {
+    for (int i = 0; i < numSamples; i++) {
+        SampleType input = samples[i];
+        samples[i] = (input + previous) * 0.5f;
+        previous = input;
+    }
+}
+
+//one curve over the block, antialiased or not. function takes a sample or a register, integral is its antiderivative
+template <bool isAntialiased, typename SampleType, typename Function, typename Integral>
+static void curveStage(SampleType* samples, int numSamples, SampleType& previous, Function&& function, Integral&& integral) {
+    if constexpr (isAntialiased) {
+        antialiasedStage(samples, numSamples, previous, function, integral);
+    }
+    else {
+        mapStage(samples, numSamples, function);
+    }
+}
+
+//the drive section, one instantiation per curve and flag combination. previous holds the last input of each curve
+template <typename SampleType, int curve, bool isClip, bool isEven, bool clipPeaks, FastMath::Accuracy accuracy, bool isAntialiased>
+static void shapeStage(SampleType* samples, int numSamples, const WaveShaper::Settings& settings, SIMDHelpers::ElementType<SampleType> dcCoefficient,
+    SampleType& dcIn, SampleType& dcOut, SampleType* previous) {
+    //the antialiased curves are always precise, eco's approximations are too rough to take differences of
+    constexpr FastMath::Accuracy curveAccuracy = isAntialiased ? FastMath::precise : accuracy;
+    auto shape = [&](auto x) { return WaveShaper::shape<curve, clipPeaks, curveAccuracy>(x, settings); };
+    auto integral = [&](double x) { return WaveShaper::shapeIntegral<curve, clipPeaks>(x, settings); };
+
+    if constexpr (!isClip) { //saturation
+        //apply bias
+        curveStage<isAntialiased>(samples, numSamples, previous[0], [&](auto x) { return shape(x + BIAS) - BIAS; },
+            [&](double x) { return integral(x + BIAS) - BIAS * x; });
+
+        if constexpr (!isEven) { //symmetric
+            curveStage<isAntialiased>(samples, numSamples, previous[1], shape, integral);
+        }
+
+        dcBlockStage(samples, numSamples, dcCoefficient, dcIn, dcOut);
+    }
+    else if constexpr (!isEven) { //symmetric clipping
+        curveStage<isAntialiased>(samples, numSamples, previous[0], shape, integral);
+    }
+    else { //asymmetric clipping
+        curveStage<isAntialiased>(samples, numSamples, previous[0], [&](auto x) { return SIMDHelpers::selectPositive(x, shape(x), x); },
+            [&](double x) { return x > 0 ? integral(x) : x * x / 2; });
+        dcBlockStage(samples, numSamples, dcCoefficient, dcIn, dcOut);
+    }
+}
+
+//tanh 2nd stage
+template <typename SampleType, bool clipPeaks, FastMath::Accuracy accuracy, bool isAntialiased>
+static void tanhStage(SampleType* samples, int numSamples, const WaveShaper::Settings& settings, SampleType& previous) {
+    constexpr FastMath::Accuracy curveAccuracy = isAntialiased ? FastMath::precise : accuracy;
+
+    curveStage<isAntialiased>(samples, numSamples, previous,
+        [&](auto x) { return WaveShaper::shape<WaveShaper::hyperbolicTangent, clipPeaks, curveAccuracy>(x, settings); },
+        [&](double x) { return WaveShaper::shapeIntegral<WaveShaper::hyperbolicTangent, clipPeaks>(x, settings); });
+}
+
+//dispatch tables, indexed by the bits of the flags so the kernel is looked up once per block
+template <typename SampleType>
+using ShapeStageFunction = void (*)(SampleType*, int, const WaveShaper::Settings&, SIMDHelpers::ElementType<SampleType>, SampleType&, SampleType&, SampleType*);
+
+template <typename SampleType>
+using TanhStageFunction = void (*)(SampleType*, int, const WaveShaper::Settings&, SampleType&);
+
+static int getShapeStageIndex(int waveType, bool isClip, bool isEven, bool clipPeaks, FastMath::Accuracy accuracy, bool isAntialiased) {
+    return isAntialiased * 64 + (waveType - 1) * 16 + isClip * 8 + isEven * 4 + clipPeaks * 2 + accuracy;
+}
+
+static int getTanhStageIndex(bool clipPeaks, FastMath::Accuracy accuracy, bool isAntialiased) {
+    return isAntialiased * 4 + clipPeaks * 2 + accuracy;
+}
+
+template <typename SampleType, size_t... indices>
+static constexpr std::array<ShapeStageFunction<SampleType>, sizeof...(indices)> makeShapeStageTable(std::index_sequence<indices...>) {
+    return { { &shapeStage<SampleType, static_cast<int>((indices & 63) / 16) + 1, (indices & 8) != 0, (indices & 4) != 0, (indices & 2) != 0,
+        static_cast<FastMath::Accuracy>(indices & 1), (indices & 64) != 0>... } };
+}
+
+template <typename SampleType, size_t... indices>
+static constexpr std::array<TanhStageFunction<SampleType>, sizeof...(indices)> makeTanhStageTable(std::index_sequence<indices...>) {
+    return { { &tanhStage<SampleType, (indices & 2) != 0, static_cast<FastMath::Accuracy>(indices & 1), (indices & 4) != 0>... } };
+}
+
+template <typename SampleType>
+static constexpr auto shapeStageTable = makeShapeStageTable<SampleType>(std::make_index_sequence<128>());
+
+template <typename SampleType>
+static constexpr auto tanhStageTable = makeTanhStageTable<SampleType>(std::make_index_sequence<8>());
+
+//the dc blocker coefficient for a rate, the cutoff stays where DC_BLOCK_COEFF puts it at DC_BLOCK_RATE
+static double getDCBlockCoefficient(double sampleRate) {
+    return std::pow(DC_BLOCK_COEFF, DC_BLOCK_RATE / sampleRate);
+}
+
+//samples at a rate for the two dc blockers to decay from full scale to the silence threshold. they are in series
+//with the same cutoff, so the decay goes as n * p^n, solved for n a few times over starting from the single pole
+static double getDCBlockTailSamples(double sampleRate) {
+    double logPole = std::log(getDCBlockCoefficient(sampleRate));
+    double samples = std::log(SILENCE_THRESHOLD) / logPole;
+
+    for (int i = 0; i < 4; i++) {
+        samples = (std::log(SILENCE_THRESHOLD) - std::log(samples)) / logPole;
+    }
+    return samples;
+}
+
+//one sample through the curves of a kernel without antialiasing. the dc blocker after them takes dcInput off,
+//which is where it settles when the curves' output at 0 is what it last saw
+template <typename FloatType>
+static FloatType shapeSample(FloatType x, int shapeStageIndex, const WaveShaper::Settings& settings, FloatType dcInput) {
+    FloatType dcOutput = 0;
+    FloatType previous[3] = {};
+
+    shapeStageTable<FloatType>[shapeStageIndex](&x, 1, settings, 1, dcInput, dcOutput, previous);
+    return x;
+}
+
+//how many curves the signal goes through with these settings, each one antialiased adds half a sample of delay
+static int getNumCurves(bool isClip, bool isEven) {
+    return !isClip && !isEven ? 3 : 2;
+}
+
+//packs the state of a group of channels into one register per field and back, unused lanes are zeroed
+template <typename GroupState, typename State>
+static void loadGroupState(GroupState& group, const State* states, const int* channels, int numChannels) {
+    group.dcInput = SIMDHelpers::loadLanes(states, channels, &State::dcInput, numChannels);
+    group.dcOutput = SIMDHelpers::loadLanes(states, channels, &State::dcOutput, numChannels);
+
+    for (int i = 0; i < 3; i++) {
+        group.curveInputs[i] = SIMDHelpers::loadLanes(states, channels, &State::curveInputs, i, numChannels);
+        group.dryInputs[i] = SIMDHelpers::loadLanes(states, channels, &State::dryInputs, i, numChannels);
+        group.otherBandsInputs[i] = SIMDHelpers::loadLanes(states, channels, &State::otherBandsInputs, i, numChannels);
+    }
+}
+
+template <typename GroupState, typename State>
+static void storeGroupState(const GroupState& group, State* states, const int* channels, int numChannels) {
+    SIMDHelpers::storeLanes(group.dcInput, states, channels, &State::dcInput, numChannels);
+    SIMDHelpers::storeLanes(group.dcOutput, states, channels, &State::dcOutput, numChannels);
+
+    for (int i = 0; i < 3; i++) {
+        SIMDHelpers::storeLanes(group.curveInputs[i], states, channels, &State::curveInputs, i, numChannels);
+        SIMDHelpers::storeLanes(group.dryInputs[i], states, channels, &State::dryInputs, i, numChannels);
+        SIMDHelpers::storeLanes(group.otherBandsInputs[i], states, channels, &State::otherBandsInputs, i, numChannels);
+    }
+}
 
 //==============================================================================
 THICCAudioProcessor::THICCAudioProcessor()
@@ -31,7 +314,11 @@ THICCAudioProcessor::THICCAudioProcessor()
         std::make_unique<juce::AudioParameterBool>("peak", "Hard Clip Peaks", false),
         std::make_unique<juce::AudioParameterFloat>("type", "Saturation Type", juce::NormalisableRange<float>(1.0f, 4.0f, 1.0f), 1.0f),
         std::make_unique<juce::AudioParameterBool>("even", "Even Harmonics", false),
-        std::make_unique<juce::AudioParameterFloat>("OSFactor", "Oversampling Factor", juce::NormalisableRange<float>(1.0f, 5.0f, 1.0f), 2.0f)
+        std::make_unique<juce::AudioParameterFloat>("OSFactor", "Oversampling Factor", juce::NormalisableRange<float>(1.0f, 5.0f, 1.0f), 2.0f),
+        std::make_unique<juce::AudioParameterBool>("multirate", "Multirate Filters", false),
+        std::make_unique<juce::AudioParameterBool>("eco", "Eco Quality", false),
+        std::make_unique<juce::AudioParameterBool>("linearPhase", "Linear Phase Oversampling", false),
+        std::make_unique<juce::AudioParameterBool>("antialiasing", "Antiderivative Antialiasing", false)
     })
 #ifndef JucePlugin_PreferredChannelConfigurations
      , AudioProcessor (BusesProperties()
@@ -58,46 +345,27 @@ THICCAudioProcessor::THICCAudioProcessor()
     typeParameter = parameters.getRawParameterValue("type");
     evenParameter = parameters.getRawParameterValue("even");
     OSFactorParameter = parameters.getRawParameterValue("OSFactor");
-
-    highPassHigh = juce::dsp::LinkwitzRileyFilter<float>();
-    highPassHigh2 = juce::dsp::LinkwitzRileyFilter<float>();
-    lowPassLow = juce::dsp::LinkwitzRileyFilter<float>();
-    lowPassLow2 = juce::dsp::LinkwitzRileyFilter<float>();
-    highPassMid = juce::dsp::LinkwitzRileyFilter<float>();
-    lowPassMid = juce::dsp::LinkwitzRileyFilter<float>();
-
-    highPassHigh.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    highPassHigh2.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    lowPassLow.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    lowPassLow2.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    highPassMid.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    lowPassMid.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-
-    int totalNumInputChannels = getTotalNumInputChannels();
-
-    dcOutput = new float[totalNumInputChannels];
-    dcInput = new float[totalNumInputChannels];
-    dcOutput2 = new float[totalNumInputChannels];
-    dcInput2 = new float[totalNumInputChannels];
-
-    inputPeakArr = new float[VOL_ARRAY_SIZE];
-    outputPeakArr = new float[VOL_ARRAY_SIZE];
-
-    for (int i = 0; i < 5; i++) {
-        OSProcessor[i] = std::make_unique<juce::dsp::Oversampling<float>>(totalNumInputChannels, i, juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR);
+    multirateParameter = parameters.getRawParameterValue("multirate");
+    ecoParameter = parameters.getRawParameterValue("eco");
+    linearPhaseParameter = parameters.getRawParameterValue("linearPhase");
+    antialiasingParameter = parameters.getRawParameterValue("antialiasing");
+
+    for (auto* parameter : getParameters()) {
+        auto* rangedParameter = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        stateParameters.push_back(rangedParameter);
+        rawParameters.push_back(parameters.getRawParameterValue(rangedParameter->getParameterID()));
     }
+    presetBank.prepare(static_cast<int>(stateParameters.size()));
 
-    resetFlag = true;
+    //checks for oversampling changes and passes recalled presets on to the parameters
+    startTimer(50);
 }
 
 THICCAudioProcessor::~THICCAudioProcessor()
 {
-    delete[] dcInput;
-    delete[] dcOutput;
-    delete[] dcInput2;
-    delete[] dcOutput2;
-    delete[] inputPeakArr;
-    delete[] outputPeakArr;
+    stopTimer();
+    releasePipeline<float>();
+    releasePipeline<double>();
 }
 
 //==============================================================================
@@ -135,89 +403,175 @@ bool THICCAudioProcessor::isMidiEffect() const
 
 double THICCAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds;
 }
 
+//the programs are the preset bank, hosts expect at least one even when it is empty
 int THICCAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return juce::jmax(1, presetBank.getNumPresets());
 }
 
 int THICCAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentPreset.load();
 }
 
 void THICCAudioProcessor::setCurrentProgram (int index)
 {
+    recallPreset(index);
 }
 
 const juce::String THICCAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return presetBank.getName(index);
 }
 
 void THICCAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    presetBank.setName(index, newName);
 }
 
 //==============================================================================
 void THICCAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    OSFactor = static_cast<int>(std::roundf(*OSFactorParameter)) - 1;
+    //nothing is playing, so the chains can be replaced directly
+    const juce::ScopedLock lock(chainLock);
 
-    struct juce::dsp::ProcessSpec processSpec = { static_cast<juce::uint32>(sampleRate * static_cast<int>(std::roundf(powf(2, OSFactor)))), 
-        static_cast<juce::uint32>(samplesPerBlock * static_cast<int>(std::roundf(powf(2, OSFactor)))), static_cast<juce::uint32>(totalNumInputChannels) };
+    //some hosts prepare with no block size and then send real blocks, which are split to fit
+    samplesPerBlock = juce::jmax(1, samplesPerBlock);
 
-    highPassHigh.prepare(processSpec);
-    highPassHigh2.prepare(processSpec);
-    lowPassLow.prepare(processSpec);
-    lowPassLow2.prepare(processSpec);
-    highPassMid.prepare(processSpec);
-    lowPassMid.prepare(processSpec);
+    currentSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
+    numChannels = getTotalNumInputChannels();
+    isDoublePrecision = isUsingDoublePrecision();
 
-    for (int i = 0; i < VOL_ARRAY_SIZE; i++) {
-        inputPeakArr[i] = -96.0f;
-        outputPeakArr[i] = -96.0f;
-    }
+    //only the precision the host asked for keeps any memory
+    releasePipeline<float>();
+    releasePipeline<double>();
+    swappedLatency.store(-1);
+
+    fadeLength = juce::roundToInt(sampleRate * OS_FADE_TIME);
 
-    
-    for (int i = 0; i < totalNumInputChannels; i++) {
-        dcOutput[i] = 0;
-        dcInput[i] = 0;
+    requestedFactor = static_cast<int>(std::roundf(*OSFactorParameter)) - 1;
+    requestedLinearPhase = *linearPhaseParameter > 0.5f;
 
-        dcOutput2[i] = 0;
-        dcInput2[i] = 0;
+    if (isDoublePrecision) {
+        preparePipeline<double>(sampleRate, samplesPerBlock);
+    }
+    else {
+        preparePipeline<float>(sampleRate, samplesPerBlock);
     }
 
     volCounterMax = 2048 / samplesPerBlock;
     volCounter = 0;
 
-    OSProcessor[OSFactor]->initProcessing(samplesPerBlock);
+    loadMeter.prepare(sampleRate);
+
+    //offline, a worker for each channel after the first, up to one per core
+    if (isNonRealtime()) {
+        workerPool.start(juce::jmin(juce::SystemStats::getNumCpus(), numChannels) - 1);
+    }
+    else {
+        workerPool.stop();
+    }
 }
 
-void THICCAudioProcessor::releaseResources()
+template <typename FloatType>
+THICCAudioProcessor::Pipeline<FloatType>& THICCAudioProcessor::getPipeline()
 {
-    highPassHigh.reset();
-    highPassHigh2.reset();
-    lowPassLow.reset();
-    lowPassLow2.reset();
-    highPassMid.reset();
-    lowPassMid.reset();
-    inputPeak = outputPeak = 0;
+    if constexpr (std::is_same<FloatType, double>::value) {
+        return doublePipeline;
+    }
+    else {
+        return floatPipeline;
+    }
+}
 
-    OSProcessor[OSFactor]->reset();
+template <typename FloatType>
+void THICCAudioProcessor::preparePipeline(double sampleRate, int samplesPerBlock)
+{
+    auto& pipeline = getPipeline<FloatType>();
+
+    pipeline.activeChain = createChain<FloatType>(requestedFactor, requestedLinearPhase);
+    reportLatency(static_cast<double>(pipeline.activeChain->latency));
+
+    //multirate band split, runs at the host rate
+    struct juce::dsp::ProcessSpec baseRateSpec = { sampleRate, static_cast<juce::uint32>(samplesPerBlock), static_cast<juce::uint32>(numChannels) };
+
+    pipeline.baseRateCrossover.prepare(baseRateSpec, *lowPassParameter, *highPassParameter);
+    pipeline.wasBaseRateCrossoverRunning = false;
+
+    pipeline.mainBandBuffer.setSize(numChannels, samplesPerBlock);
+    pipeline.otherBandsBuffer.setSize(numChannels, samplesPerBlock);
+
+    //the old chain's output while switching factors
+    pipeline.fadeBuffer.setSize(numChannels, samplesPerBlock);
+
+    //every channel starts asleep, there is nothing in the filters yet
+    pipeline.gates.assign(numChannels, ChannelGate());
+    pipeline.awakeChannels.assign(numChannels, 0);
+    pipeline.numAwakeChannels = 0;
 
-    for (int i = 0; i < getTotalNumInputChannels(); i++) {
-        dcOutput[i] = 0;
-        dcInput[i] = 0;
+    //gain smoothing, snapped to the current values so playback doesn't start with a ramp
+    pipeline.inputGain.reset(sampleRate, SMOOTHING_TIME);
+    pipeline.outputGainPost.reset(sampleRate, SMOOTHING_TIME);
+
+    pipeline.inputGain.setCurrentAndTargetValue(std::pow(FloatType(10), *inputGainParameter * FloatType(0.05)));
+    pipeline.outputGainPost.setCurrentAndTargetValue(std::pow(FloatType(10), *outputGainPostParameter * FloatType(0.05)));
+}
+
+//frees the chains and buffers of one precision, never called on the audio thread
+template <typename FloatType>
+void THICCAudioProcessor::releasePipeline()
+{
+    auto& pipeline = getPipeline<FloatType>();
+
+    delete pipeline.pendingChain.exchange(nullptr);
+    delete pipeline.retiredChain.exchange(nullptr);
+    pipeline.fadingChain.reset();
+    pipeline.activeChain.reset();
+    pipeline.fadeSamplesRemaining = 0;
+    pipeline.isBypassed = false;
+    pipeline.isBypassFading = false;
+    pipeline.linearSamples = 0;
+    pipeline.warmUpSamplesBehind = 0;
+
+    pipeline.mainBandBuffer.setSize(0, 0);
+    pipeline.otherBandsBuffer.setSize(0, 0);
+    pipeline.fadeBuffer.setSize(0, 0);
+
+    pipeline.gates.clear();
+    pipeline.gates.shrink_to_fit();
+    pipeline.awakeChannels.clear();
+    pipeline.awakeChannels.shrink_to_fit();
+    pipeline.numAwakeChannels = 0;
+}
+
+//clears the filter and dc blocker state, keeps the memory
+template <typename FloatType>
+void THICCAudioProcessor::resetPipeline()
+{
+    auto& pipeline = getPipeline<FloatType>();
 
-        dcOutput2[i] = 0;
-        dcInput2[i] = 0;
+    pipeline.baseRateCrossover.reset();
+
+    if (pipeline.activeChain != nullptr) {
+        resetChain(*pipeline.activeChain);
+    }
+    if (pipeline.fadingChain != nullptr) {
+        resetChain(*pipeline.fadingChain);
     }
 
-    resetFlag = false;
+    std::fill(pipeline.gates.begin(), pipeline.gates.end(), ChannelGate());
+    pipeline.numAwakeChannels = 0;
+}
+
+void THICCAudioProcessor::releaseResources()
+{
+    resetPipeline<float>();
+    resetPipeline<double>();
+    inputPeak = outputPeak = 0;
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -231,8 +585,52 @@ bool THICCAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
 #endif
 
 void THICCAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+void THICCAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer);
+}
+
+bool THICCAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+//the whole block, at the precision the host prepared for. some hosts send more samples than they prepared for,
+//and everything is sized for maxBlockSize, so those blocks go through in pieces that fit
+template <typename FloatType>
+void THICCAudioProcessor::process(juce::AudioBuffer<FloatType>& buffer)
+{
+    int numSamples = buffer.getNumSamples();
+
+    if (numSamples <= maxBlockSize || maxBlockSize == 0) {
+        processPiece(buffer);
+        return;
+    }
+
+    for (int start = 0; start < numSamples; start += maxBlockSize) {
+        //refers to the host's channels, nothing is copied, and up to 32 channels nothing is allocated
+        juce::AudioBuffer<FloatType> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, juce::jmin(maxBlockSize, numSamples - start));
+        processPiece(piece);
+    }
+}
+
+//a block no longer than maxBlockSize
+template <typename FloatType>
+void THICCAudioProcessor::processPiece(juce::AudioBuffer<FloatType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
+    LoadMeter::BlockTimer blockTimer(loadMeter, buffer.getNumSamples());
+
+    //a preset recalled since the last block takes effect from this one, all its values at once
+    int preset = pendingPreset.exchange(-1);
+    if (preset >= 0) {
+        applyPreset(preset);
+    }
+    numBlocksProcessed.fetch_add(1, std::memory_order_relaxed);
     int totalNumInputChannels  = getTotalNumInputChannels();
     int totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -242,175 +640,647 @@ void THICCAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
     for (int i = totalNumInputChannels; i < totalNumOutputChannels; i++)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    //apply input gain
-    buffer.applyGain(powf(10, *inputGainParameter * 0.05f));
+    //the per-channel state is sized for the layout at prepare time
+    jassert(totalNumInputChannels <= numChannels);
+    totalNumInputChannels = juce::jmin(totalNumInputChannels, numChannels);
 
-    if (buffer.getMagnitude(0, buffer.getNumSamples()) > 0.00003f) { //if peak is under -90.4575749 dBFS, do not process
+    auto& pipeline = getPipeline<FloatType>();
 
-        resetFlag = true;
+    //the host is running at a precision it didn't prepare for
+    if (pipeline.activeChain == nullptr) {
+        jassertfalse;
+        return;
+    }
 
-        //oversamples
-        auto audioBlock = juce::dsp::AudioBlock<float>(buffer);
-        auto OSAudioBlock = OSProcessor[OSFactor]->processSamplesUp(audioBlock);
+    //picks up a chain built for a new oversampling factor, one switch at a time and only while the chain is running
+    if (pipeline.fadingChain == nullptr && !pipeline.isBypassed && !pipeline.isBypassFading) {
+        if (auto* nextChain = pipeline.pendingChain.exchange(nullptr)) {
+            pipeline.fadingChain = std::move(pipeline.activeChain);
+            pipeline.activeChain.reset(nextChain);
+            pipeline.fadeSamplesRemaining = fadeLength;
+            swappedLatency.store(static_cast<double>(nextChain->latency));
+        }
+    }
 
-        //waveshape vars
-        int waveType = static_cast<int>(std::roundf(*typeParameter));
-        float knee = 1 - (*kneeParameter / 100);
-        float softness = *softnessParameter / 100;
-        bool clipPeaks = *peakParameter > 0.5f;
-        bool isEven = *evenParameter > 0.5f;
+    //parameter snapshot, read once per block
+    int waveType = static_cast<int>(std::roundf(*typeParameter));
+    float knee = 1 - (*kneeParameter / 100);
+    float softness = *softnessParameter / 100;
+    bool isClip = *clipParameter > 0.5f;
+    bool clipPeaks = *peakParameter > 0.5f;
+    bool isEven = *evenParameter > 0.5f;
+    FastMath::Accuracy accuracy = *ecoParameter > 0.5f ? FastMath::eco : FastMath::precise;
+    bool isAntialiased = *antialiasingParameter > 0.5f;
+
+    ChainParameters chainParameters;
+    chainParameters.lowPass = *lowPassParameter;
+    chainParameters.highPass = *highPassParameter;
+    chainParameters.drive = powf(10, *driveParameter * 0.05f);
+    chainParameters.outputGainPre = powf(10, *outputGainPreParameter * 0.05f);
+    chainParameters.mix = *mixParameter / 100;
+    chainParameters.isMultirate = *multirateParameter > 0.5f;
+
+    WetChainSettings settings;
+    settings.shapeStageIndex = getShapeStageIndex(waveType, isClip, isEven, clipPeaks, accuracy, isAntialiased);
+    settings.tanhStageIndex = getTanhStageIndex(clipPeaks, accuracy, isAntialiased);
+    settings.numAntialiasedCurves = isAntialiased ? getNumCurves(isClip, isEven) : 0;
+    settings.probeShapeStageIndex = getShapeStageIndex(waveType, isClip, isEven, clipPeaks, accuracy, false);
+    settings.probeTanhStageIndex = getTanhStageIndex(clipPeaks, accuracy, false);
+    settings.curve = WaveShaper::makeSettings(softness, 0);
+    settings.tanh = WaveShaper::makeSettings(1, knee);
+    settings.isMixedLater = false;
+
+    //the meters only run while someone is looking at them
+    settings.isMetered = isMeteringEnabled.load(std::memory_order_relaxed);
+    if (settings.isMetered && !wasMetering) {
+        inputPeak = outputPeak = 0;
+        volCounter = 0;
+    }
+    wasMetering = settings.isMetered;
 
-        //eq vars
-        bool isFilterOn = *highPassParameter != 20.0f || *lowPassParameter != 20000.0f;
+    pipeline.inputGain.setTargetValue(std::pow(FloatType(10), *inputGainParameter * FloatType(0.05)));
+    pipeline.outputGainPost.setTargetValue(std::pow(FloatType(10), *outputGainPostParameter * FloatType(0.05)));
 
-        //processes samples
-        for (int channel = 0; channel < totalNumInputChannels; channel++)
-        {
-            for (int sample = 0; sample < OSAudioBlock.getNumSamples(); sample++) {
-                //get sample data
-                float sampleData = OSAudioBlock.getSample(channel, sample);
+    //apply input gain
+    pipeline.inputGain.applyGain(buffer, buffer.getNumSamples());
 
-                //eq vars
-                float otherBand1 = 0;
-                float otherBand2 = 0;
-                float otherBand3 = 0;
-                float mainBand = 0;
+    //crossover coefficients, only recomputed when the cutoffs move
+    pipeline.baseRateCrossover.setFrequencies(chainParameters.lowPass, chainParameters.highPass, buffer.getNumSamples());
 
-                //save original for mix
-                float originalSampleData = sampleData;
+    bool isFading = pipeline.fadingChain != nullptr && pipeline.fadeSamplesRemaining > 0;
+    auto audioBlock = juce::dsp::AudioBlock<FloatType>(buffer).getSubsetChannelBlock(0, totalNumInputChannels);
 
-                //input peak
-                if (abs(sampleData) > inputPeak) {
-                    inputPeak = abs(sampleData);
-                }
+    //any channel with input wakes up, the rest keep running until their tail has died away.
+    //a sleeping channel is left as it is, it is under the threshold anyway
+    pipeline.numAwakeChannels = 0;
+    FloatType blockPeak = 0; //of the awake channels
 
-                if (isFilterOn) {
-                    if (*highPassParameter < 21.0f) { //only low pass on
-                        lowPassLow.setCutoffFrequency(*lowPassParameter);
-                        highPassHigh.setCutoffFrequency(*lowPassParameter);
+    for (int channel = 0; channel < totalNumInputChannels; channel++) {
+        ChannelGate& gate = pipeline.gates[channel];
+        FloatType magnitude = buffer.getMagnitude(channel, 0, buffer.getNumSamples());
 
-                        otherBand1 = highPassHigh.processSample(channel, sampleData); //high band
+        if (magnitude > SILENCE_THRESHOLD) {
+            gate.quietSamples = 0;
+            gate.isAsleep = false;
+        }
+        else if (!gate.isAsleep) {
+            gate.quietSamples += buffer.getNumSamples();
+        }
 
-                        mainBand = lowPassLow.processSample(channel, sampleData); //low band
-                    }
-                    else if (*lowPassParameter > 19999.0f) { //only high pass on
-                        lowPassLow.setCutoffFrequency(*highPassParameter);
-                        highPassHigh.setCutoffFrequency(*highPassParameter);
+        if (!gate.isAsleep) {
+            pipeline.awakeChannels[pipeline.numAwakeChannels++] = channel;
+            blockPeak = juce::jmax(blockPeak, magnitude);
+        }
+    }
 
-                        otherBand1 = lowPassLow.processSample(channel, sampleData); //low band
+    const int* awakeChannels = pipeline.awakeChannels.data();
+    int numAwakeChannels = pipeline.numAwakeChannels;
+
+    if (numAwakeChannels > 0) {
+        auto& chain = *pipeline.activeChain;
+
+        //blocks that are dry, or quiet enough that the curves are a straight line, take the fast path instead of the chain,
+        //decided once per block. it only takes over from the chain once everything still in its delay was linear too.
+        //switching to it is a crossfade. leaving a dry block fades back to the chain. leaving a linear one, the chain is
+        //first warmed up on the input the fast path holds, a couple of blocks' worth per block while the fast path keeps
+        //playing, so it is where it would have been had it never stopped when it fades back in. both wait while the
+        //factor is switching.
+        int numSamples = buffer.getNumSamples();
+        int delay = juce::roundToInt(chain.latency);
+        bool isDry = chainParameters.mix == 0;
+        FloatType bypassGain = pipeline.bypassGain;
+        bool canBypass = pipeline.pendingChain.load() == nullptr && getBypassGain(chain, chainParameters, settings, blockPeak, bypassGain);
+
+        pipeline.linearSamples = canBypass && !isDry ? juce::jmin(pipeline.linearSamples + numSamples, 1 << 30) : 0;
+        canBypass = canBypass && (isDry || pipeline.linearSamples >= numSamples + delay);
+
+        if (pipeline.fadingChain == nullptr) {
+            if (canBypass && !pipeline.isBypassed && !pipeline.isBypassFading) {
+                //the fast path's dc blocker carries on from the chain's
+                for (auto& state : chain.channelStates) {
+                    state.bypassDCInput = state.dcInput2;
+                    state.bypassDCOutput = state.dcOutput2;
+                }
 
-                        mainBand = highPassHigh.processSample(channel, sampleData); //high band
+                pipeline.isBypassed = true;
+                pipeline.isBypassDry = isDry;
+                pipeline.isBypassFading = true;
+                pipeline.fadeSamplesRemaining = fadeLength;
+                pipeline.bypassGain = bypassGain;
+            }
+            else if (!canBypass && pipeline.isBypassed && pipeline.warmUpSamplesBehind == 0) {
+                if (pipeline.isBypassFading) {
+                    //the chain is still running, so the fade turns around, or stops there for a linear block
+                    pipeline.isBypassed = false;
+                    pipeline.isBypassFading = pipeline.isBypassDry;
+                    pipeline.fadeSamplesRemaining = pipeline.isBypassDry ? fadeLength - pipeline.fadeSamplesRemaining : 0;
+                }
+                else {
+                    resumeChain(chain, shapeSample(FloatType(0), settings.probeShapeStageIndex, settings.curve, FloatType(0)));
+
+                    if (pipeline.isBypassDry) {
+                        pipeline.isBypassed = false;
+                        pipeline.isBypassFading = true;
+                        pipeline.fadeSamplesRemaining = fadeLength;
                     }
-                    else { //3 band split
-                        lowPassLow.setCutoffFrequency(*highPassParameter);
-                        lowPassLow2.setCutoffFrequency(*lowPassParameter);
-                        highPassHigh.setCutoffFrequency(*lowPassParameter);
-                        highPassHigh2.setCutoffFrequency(*lowPassParameter);
-                        highPassMid.setCutoffFrequency(*highPassParameter);
-                        lowPassMid.setCutoffFrequency(*lowPassParameter);
-
-                        //low band
-                        otherBand1 = lowPassLow.processSample(channel, sampleData);
-                        otherBand3 = highPassHigh2.processSample(channel, otherBand1);
-
-                        otherBand1 = lowPassLow2.processSample(channel, otherBand1);
-                        //mid band
-                        mainBand = highPassMid.processSample(channel, sampleData);
-                        //high band
-                        otherBand2 = highPassHigh.processSample(channel, mainBand);
-
-                        mainBand = lowPassMid.processSample(channel, mainBand);
+                    else {
+                        pipeline.warmUpSamplesBehind = chain.bypassLength;
                     }
+                }
+            }
+
+            //the fast path plays this block unless the chain has caught up with the input before it
+            if (pipeline.warmUpSamplesBehind > 0) {
+                warmUpChain(chain, chainParameters, settings, WARM_UP_SPEED * numSamples);
 
-                    sampleData = mainBand;
+                if (pipeline.warmUpSamplesBehind == 0) {
+                    pipeline.isBypassed = false;
+                    pipeline.isBypassFading = true;
+                    pipeline.fadeSamplesRemaining = fadeLength;
+                }
+                else {
+                    pipeline.warmUpSamplesBehind += numSamples;
                 }
+            }
+        }
 
-                //apply drive
-                sampleData *= powf(10, *driveParameter * 0.05f);
+        bool isBypassFading = pipeline.isBypassFading;
+        bool isChainRunning = !pipeline.isBypassed || isBypassFading;
 
-                if (*clipParameter < 0.5f) { //saturation
-                    //apply bias
-                    sampleData += BIAS;
-                    sampleData = waveShape(sampleData, waveType, softness, 0, clipPeaks);
-                    sampleData -= BIAS;
+        //the fast path delays by the chain's latency, its delay line follows the input while the chain runs on its own
+        if (!pipeline.isBypassed && !isBypassFading) {
+            for (int i = 0; i < numAwakeChannels; i++) {
+                pushDelayStage(buffer.getReadPointer(awakeChannels[i]), numSamples, chain.bypassDelay.getWritePointer(awakeChannels[i]), chain.bypassLength);
+            }
+        }
 
-                    if (!isEven) { //symmetric
-                        sampleData = waveShape(sampleData, waveType, softness, 0, clipPeaks);
-                    }
+        //band split at the host rate for the multirate mode, the bypassed bands never see the oversampler
+        bool isBaseRateCrossoverRunning = isChainRunning && chainParameters.isMultirate && pipeline.baseRateCrossover.isActive();
 
-                    //dc blocker
-                    dcOutput[channel] = sampleData - dcInput[channel] + DC_BLOCK_COEFF * dcOutput[channel];
-                    dcInput[channel] = sampleData;
-                    sampleData = dcOutput[channel];
-                }
-                else { //clipping
-                    //waveshape
-                    if (!isEven) { //symmetric
-                        sampleData = waveShape(sampleData, waveType, softness, 0, clipPeaks);
-                    }
-                    else { //asymmetric
-                        sampleData = sampleData > 0 ? waveShape(sampleData, waveType, softness, 0, clipPeaks) : sampleData;
+        if (isBaseRateCrossoverRunning) {
+            LoadMeter::StageTimer stages(loadMeter);
 
-                        //dc blocker
-                        dcOutput[channel] = sampleData - dcInput[channel] + DC_BLOCK_COEFF * dcOutput[channel];
-                        dcInput[channel] = sampleData;
-                        sampleData = dcOutput[channel];
-                    }
-                }
+            if (!pipeline.wasBaseRateCrossoverRunning) {
+                pipeline.baseRateCrossover.reset();
+            }
 
-                //tanh 2nd stage
-                sampleData = waveShape(sampleData, 4, 1, knee, clipPeaks);
+            for (int i = 0; i < numAwakeChannels; i++) {
+                int channel = awakeChannels[i];
+                pipeline.mainBandBuffer.copyFrom(channel, 0, buffer, channel, 0, buffer.getNumSamples());
+                pipeline.baseRateCrossover.processBlock(channel, pipeline.mainBandBuffer.getWritePointer(channel), pipeline.otherBandsBuffer.getWritePointer(channel), buffer.getNumSamples());
+            }
 
-                //reverse drive
-                sampleData /= powf(10, *driveParameter * 0.05f);
+            stages.lap(LoadMeter::bandSplit);
+        }
 
-                //apply output gain pre-mix
-                sampleData *= powf(10, *outputGainPreParameter * 0.05f);
+        //while the chain catches up, the crossover is with it rather than with this block
+        pipeline.wasBaseRateCrossoverRunning = isBaseRateCrossoverRunning || (pipeline.warmUpSamplesBehind > 0 && pipeline.wasBaseRateCrossoverRunning);
 
-                if (isFilterOn) { //adds the other bands back in and apply mix
-                    sampleData = sampleData * (*mixParameter / 100) + mainBand * (1 - (*mixParameter / 100)) + otherBand1 + otherBand2 + otherBand3;
-                }
-                else {
-                    //apply mix
-                    sampleData = sampleData * (*mixParameter / 100) + originalSampleData * (1 - (*mixParameter / 100));
-                }
+        //what is fading out runs on its own copy of the input until it is gone: the old chain while switching factors,
+        //the chain or the fast path while switching between them
+        if (isFading || isBypassFading) {
+            for (int i = 0; i < numAwakeChannels; i++) {
+                pipeline.fadeBuffer.copyFrom(awakeChannels[i], 0, buffer, awakeChannels[i], 0, buffer.getNumSamples());
+            }
 
-                //output peak
-                if (abs(sampleData) > outputPeak) {
-                    outputPeak = abs(sampleData);
-                }
+            auto fadeBlock = juce::dsp::AudioBlock<FloatType>(pipeline.fadeBuffer).getSubBlock(0, buffer.getNumSamples());
 
-                //dc blocker
-                dcOutput2[channel] = sampleData - dcInput2[channel] + DC_BLOCK_COEFF * dcOutput2[channel];
-                dcInput2[channel] = sampleData;
-                sampleData = dcOutput2[channel];
+            if (isFading) {
+                processChain(*pipeline.fadingChain, fadeBlock, chainParameters, settings);
+            }
+            else if (pipeline.isBypassed) {
+                processChain(chain, fadeBlock, chainParameters, settings);
+            }
+            else {
+                processBypass(chain, fadeBlock, pipeline.bypassGain, pipeline.bypassGain, settings.isMetered);
+            }
+        }
 
-                //set sample data
-                OSAudioBlock.setSample(channel, sample, sampleData);
+        if (pipeline.isBypassed) {
+            processBypass(chain, audioBlock, pipeline.bypassGain, bypassGain, settings.isMetered);
+            pipeline.bypassGain = bypassGain;
+        }
+        else {
+            processChain(chain, audioBlock, chainParameters, settings);
+        }
+
+        if (isFading || isBypassFading) {
+            //linear crossfade from the old output to the new one
+            int fadePosition = fadeLength - pipeline.fadeSamplesRemaining;
+
+            for (int i = 0; i < numAwakeChannels; i++) {
+                FloatType* channelData = buffer.getWritePointer(awakeChannels[i]);
+                const FloatType* fadeData = pipeline.fadeBuffer.getReadPointer(awakeChannels[i]);
+
+                for (int sample = 0; sample < buffer.getNumSamples(); sample++) {
+                    FloatType gain = juce::jmin(FloatType(1), static_cast<FloatType>(fadePosition + sample) / fadeLength);
+                    channelData[sample] = channelData[sample] * gain + fadeData[sample] * (1 - gain);
+                }
             }
+
+            pipeline.fadeSamplesRemaining = juce::jmax(0, pipeline.fadeSamplesRemaining - buffer.getNumSamples());
+            pipeline.isBypassFading = isBypassFading && pipeline.fadeSamplesRemaining > 0;
         }
 
-        OSProcessor[OSFactor]->processSamplesDown(audioBlock);
+        //a channel goes to sleep once its input has been quiet for longer than the oversampler holds on to it
+        //and what is still coming out of the filters and dc blockers is under the threshold. not while switching
+        //factors or paths, the fast path's delay holds on to it just as long.
+        if (!isFading && !isBypassFading && pipeline.warmUpSamplesBehind == 0) {
+            int tailSamples = static_cast<int>(std::ceil(chain.latency));
 
-        
+            for (int i = 0; i < numAwakeChannels; i++) {
+                int channel = awakeChannels[i];
+                ChannelGate& gate = pipeline.gates[channel];
+
+                if (gate.quietSamples > tailSamples && buffer.getMagnitude(channel, 0, buffer.getNumSamples()) <= SILENCE_THRESHOLD) {
+                    gate.isAsleep = true;
+                    resetChannel(chain, channel, shapeSample(FloatType(0), settings.probeShapeStageIndex, settings.curve, FloatType(0)));
+                }
+            }
+        }
     }
-    else if (resetFlag) {
-        releaseResources();
+    else {
+        //keep the ramps moving so they don't jump when audio resumes
+        auto& chain = *pipeline.activeChain;
+        int OSNumSamples = buffer.getNumSamples() << chain.factor;
+        chain.drive.skip(OSNumSamples);
+        chain.outputGainPre.skip(OSNumSamples);
+        chain.mix.skip(OSNumSamples);
+
+        //nothing to fade across in silence
+        pipeline.fadeSamplesRemaining = 0;
+        pipeline.isBypassFading = false;
     }
 
-    if (++volCounter >= volCounterMax) {
-        for (int i = VOL_ARRAY_SIZE - 1; i > 0; i--) {
-            inputPeakArr[i] = inputPeakArr[i - 1];
-            outputPeakArr[i] = outputPeakArr[i - 1];
-        }
-        inputPeakArr[0] = fmaxf(20.0f * log10(inputPeak), -96.0f) / 18.0f;
-        outputPeakArr[0] = fmaxf(20.0f * log10(outputPeak), -96.0f) / 18.0f;
+    //hands the old chain back to be deleted off the audio thread
+    if (pipeline.fadingChain != nullptr && pipeline.fadeSamplesRemaining == 0 && pipeline.retiredChain.load() == nullptr) {
+        pipeline.retiredChain.store(pipeline.fadingChain.release());
+    }
+
+    //hands a frame of peaks to the editor
+    if (settings.isMetered && ++volCounter >= volCounterMax) {
+        peakFrames.push({ fmaxf(20.0f * log10(inputPeak), -96.0f) / 18.0f, fmaxf(20.0f * log10(outputPeak), -96.0f) / 18.0f });
         inputPeak = outputPeak = 0;
         volCounter = 0;
     }
 
     //apply output gain
-    buffer.applyGain(powf(10, *outputGainPostParameter * 0.05f));
+    pipeline.outputGainPost.applyGain(buffer, buffer.getNumSamples());
+}
+
+//oversamples the block, runs the band split and wet chain, and brings it back down to the host rate
+template <typename FloatType>
+void THICCAudioProcessor::processChain(OversampledChain<FloatType>& chain, juce::dsp::AudioBlock<FloatType> block, const ChainParameters& chainParameters, WetChainSettings settings)
+{
+    using Register = SIMDHelpers::Register<FloatType>;
+    auto& pipeline = getPipeline<FloatType>();
+
+    //only the channels that are awake are processed, sleeping ones are left in the block as they are
+    const int* awakeChannels = pipeline.awakeChannels.data();
+    int numAwakeChannels = pipeline.numAwakeChannels;
+    int numSamples = static_cast<int>(block.getNumSamples());
+    int OSNumSamples = numSamples << chain.factor;
+
+    chain.drive.setTargetValue(chainParameters.drive);
+    chain.outputGainPre.setTargetValue(chainParameters.outputGainPre);
+    chain.mix.setTargetValue(chainParameters.mix);
+
+    //crossover coefficients, only recomputed when the cutoffs move
+    chain.crossover.setFrequencies(chainParameters.lowPass, chainParameters.highPass, OSNumSamples);
+
+    //multirate mode splits the bands at the host rate and only oversamples the band being processed.
+    //at 1x there is nothing to gain, so the normal path is used.
+    bool isSplitAtBaseRate = chainParameters.isMultirate && pipeline.baseRateCrossover.isActive() && chain.factor > 0;
+
+    //switching between the split paths, clear whatever state the other path left behind
+    if (isSplitAtBaseRate != chain.wasSplitAtBaseRate) {
+        resetChain(chain);
+        chain.wasSplitAtBaseRate = isSplitAtBaseRate;
+    }
+
+    //gain ramps, shared by every channel
+    jassert(OSNumSamples <= chain.maxOSBlockSize);
+
+    for (int sample = 0; sample < OSNumSamples; sample++) {
+        FloatType driveGain = chain.drive.getNextValue();
+        chain.driveRamp[sample] = driveGain;
+        chain.postDriveRamp[sample] = chain.outputGainPre.getNextValue() / driveGain;
+        chain.mixRamp[sample] = chain.mix.getNextValue();
+    }
+
+    //eq vars
+    bool isFilterOn = chain.crossover.isActive() && !isSplitAtBaseRate;
+    int OSBlockSize = OSNumSamples;
+
+    settings.isMixedLater = isSplitAtBaseRate;
+
+    //antialiasing delays the processed band by another half a sample per curve at the oversampled rate
+    if (isSplitAtBaseRate) {
+        FloatType bandDelay = chain.latency + static_cast<FloatType>(settings.numAntialiasedCurves) / (2 << chain.factor);
+        chain.mainBandDelay.setDelay(bandDelay);
+        chain.otherBandsDelay.setDelay(bandDelay);
+    }
+
+    //every channel has its own filter state and delay line, so apart from the oversampler the work is split into tasks
+    //that each touch one channel or one group of channels. offline they are spread over the worker pool, and the result
+    //is the same as running them in order. each task keeps its own peaks, they are combined at the end.
+    bool isParallel = isNonRealtime() && workerPool.getNumWorkers() > 0;
+    std::fill(chain.inputPeaks.begin(), chain.inputPeaks.begin() + numAwakeChannels, FloatType(0));
+    std::fill(chain.outputPeaks.begin(), chain.outputPeaks.begin() + numAwakeChannels, FloatType(0));
+
+    //input peak, then multirate leaves only the main band in the block for the oversampler
+    auto meterChannel = [&](int i) {
+        int channel = awakeChannels[i];
+        LoadMeter::StageTimer stages(loadMeter);
+
+        //the meters run at the host rate, on the whole signal
+        if (settings.isMetered) {
+            peakStage(block.getChannelPointer(channel), numSamples, chain.inputPeaks[i]);
+            stages.lap(LoadMeter::metering);
+        }
+
+        if (isSplitAtBaseRate) {
+            std::copy(pipeline.mainBandBuffer.getReadPointer(channel), pipeline.mainBandBuffer.getReadPointer(channel) + numSamples, block.getChannelPointer(channel));
+            stages.lap(LoadMeter::bandSplit);
+        }
+    };
+
+    //the band split leaves the band to process in the oversampled block
+    auto splitChannel = [&](int i) {
+        int channel = awakeChannels[i];
+        LoadMeter::StageTimer stages(loadMeter);
+
+        if (isFilterOn) {
+            chain.crossover.processBlock(channel, chain.awakeOSChannels[i], chain.awakeOtherBands[i], OSBlockSize);
+            stages.lap(LoadMeter::bandSplit);
+        }
+    };
+
+    //the awake channels go through in groups that fill the lanes of a register, so any layout
+    //from stereo to 7.1.4 is vectorized. a single channel left over (or mono) runs on its own.
+    //each group has its own stretch of scratch.
+    int laneCount = static_cast<int>(Register::size());
+    int numGroups = (numAwakeChannels + laneCount - 1) / laneCount;
+    ChannelState<FloatType>* states = chain.channelStates.data();
+
+    auto processGroup = [&](int group) {
+        int first = group * laneCount;
+        int groupSize = juce::jmin(laneCount, numAwakeChannels - first);
+        const int* groupChannels = awakeChannels + first;
+        size_t scratchOffset = static_cast<size_t>(group * chain.maxOSBlockSize);
+        LoadMeter::StageTimer stages(loadMeter);
+
+        if (groupSize == 1) {
+            processWetChain(chain, chain.awakeOSChannels[first], chain.dryBlock.data() + scratchOffset, isFilterOn ? chain.awakeOtherBands[first] : nullptr, OSBlockSize, settings,
+                states[groupChannels[0]], stages);
+            return;
+        }
+
+        Register* interleavedBlock = chain.interleavedBlock.data() + scratchOffset;
+        Register* interleavedOtherBands = chain.interleavedOtherBands.data() + scratchOffset;
+        auto groupBlock = juce::dsp::AudioBlock<FloatType>(chain.awakeOSChannels.data() + first, static_cast<size_t>(groupSize), static_cast<size_t>(OSBlockSize));
+
+        SIMDHelpers::interleave(groupBlock, interleavedBlock);
+        if (isFilterOn) {
+            auto otherBandsGroupBlock = juce::dsp::AudioBlock<FloatType>(chain.awakeOtherBands.data() + first, static_cast<size_t>(groupSize), static_cast<size_t>(OSBlockSize));
+            SIMDHelpers::interleave(otherBandsGroupBlock, interleavedOtherBands);
+        }
+
+        ChannelState<Register> groupState;
+        loadGroupState(groupState, states, groupChannels, groupSize);
+
+        processWetChain(chain, interleavedBlock, chain.interleavedDry.data() + scratchOffset, isFilterOn ? interleavedOtherBands : nullptr, OSBlockSize, settings,
+            groupState, stages);
+
+        storeGroupState(groupState, states, groupChannels, groupSize);
+
+        SIMDHelpers::deinterleave(interleavedBlock, groupBlock);
+        stages.lap(LoadMeter::shaping);
+    };
+
+    //back down to the host rate, where multirate recombines the processed band with the delayed dry band and bypassed bands,
+    //then the output meter and the final dc blocker, which have no reason to run at the oversampled rate
+    auto joinChannel = [&](int i) {
+        int channel = awakeChannels[i];
+        FloatType* channelData = block.getChannelPointer(channel);
+        LoadMeter::StageTimer stages(loadMeter);
+
+        if (isSplitAtBaseRate) {
+            const FloatType* mainBandData = pipeline.mainBandBuffer.getReadPointer(channel);
+            const FloatType* otherBandsData = pipeline.otherBandsBuffer.getReadPointer(channel);
+
+            for (int sample = 0; sample < numSamples; sample++) {
+                chain.mainBandDelay.pushSample(channel, mainBandData[sample]);
+                chain.otherBandsDelay.pushSample(channel, otherBandsData[sample]);
+
+                FloatType mixValue = chain.mixRamp[sample << chain.factor];
+                channelData[sample] = channelData[sample] * mixValue + chain.mainBandDelay.popSample(channel) * (1 - mixValue) + chain.otherBandsDelay.popSample(channel);
+            }
+            stages.lap(LoadMeter::bandSplit);
+        }
+
+        if (settings.isMetered) {
+            peakStage(channelData, numSamples, chain.outputPeaks[i]);
+            stages.lap(LoadMeter::metering);
+        }
+
+        dcBlockStage(channelData, numSamples, chain.outputDCCoefficient, chain.channelStates[channel].dcInput2, chain.channelStates[channel].dcOutput2);
+        stages.lap(LoadMeter::dcBlock);
+    };
+
+    //the oversampler takes every channel of the bus at once. a sleeping channel is fed silence, which clears what it
+    //left in the filters the way a reset would, and what comes back down for it is dropped
+    int numBusChannels = static_cast<int>(chain.upChannels.size());
+    std::fill(chain.upChannels.begin(), chain.upChannels.end(), chain.silence.data());
+    std::fill(chain.downChannels.begin(), chain.downChannels.end(), chain.droppedOutput.data());
+
+    for (int i = 0; i < numAwakeChannels; i++) {
+        chain.upChannels[awakeChannels[i]] = block.getChannelPointer(awakeChannels[i]);
+        chain.downChannels[awakeChannels[i]] = block.getChannelPointer(awakeChannels[i]);
+    }
+
+    runTasks(numAwakeChannels, isParallel, meterChannel);
+    {
+        LoadMeter::StageTimer stages(loadMeter);
+        auto OSBlock = chain.oversampler->processSamplesUp(juce::dsp::AudioBlock<const FloatType>(chain.upChannels.data(), static_cast<size_t>(numBusChannels), static_cast<size_t>(numSamples)));
+
+        //getWritePointer marks the buffer as not clear, so the tasks mustn't call it at the same time
+        FloatType* const* otherBandsChannels = chain.otherBandsOSBuffer.getArrayOfWritePointers();
+
+        for (int i = 0; i < numAwakeChannels; i++) {
+            chain.awakeOSChannels[i] = OSBlock.getChannelPointer(awakeChannels[i]);
+            chain.awakeOtherBands[i] = otherBandsChannels[awakeChannels[i]];
+        }
+        stages.lap(LoadMeter::upsample);
+    }
+    runTasks(numAwakeChannels, isParallel, splitChannel);
+    runTasks(numGroups, isParallel, processGroup);
+    {
+        LoadMeter::StageTimer stages(loadMeter);
+        juce::dsp::AudioBlock<FloatType> downBlock(chain.downChannels.data(), static_cast<size_t>(numBusChannels), static_cast<size_t>(numSamples));
+        chain.oversampler->processSamplesDown(downBlock);
+        stages.lap(LoadMeter::downsample);
+    }
+    runTasks(numAwakeChannels, isParallel, joinChannel);
+
+    //the meters are float, the peaks are kept at the chain's precision for the block
+    FloatType inputPeakValue = inputPeak;
+    FloatType outputPeakValue = outputPeak;
+
+    for (int i = 0; i < numAwakeChannels; i++) {
+        inputPeakValue = juce::jmax(inputPeakValue, chain.inputPeaks[i]);
+        outputPeakValue = juce::jmax(outputPeakValue, chain.outputPeaks[i]);
+    }
+
+    inputPeak = static_cast<float>(inputPeakValue);
+    outputPeak = static_cast<float>(outputPeakValue);
+}
+
+//whether the block can take the fast path, and with what gain. a dry chain only delays the input, with a band split the bands
+//sum back to it up to the crossover's phase. otherwise the drive section is compared to the tangent at 0 out to the
+//block's peak on both sides, using the block's own kernels, and the block is linear if the difference is under
+//LINEAR_TOLERANCE at the output. the smoothers have to have arrived, the fast path has one gain for the whole block.
+//the oversampler's phase and antialiasing's half samples are left out, the crossfades between the paths cover those.
+template <typename FloatType>
+bool THICCAudioProcessor::getBypassGain(const OversampledChain<FloatType>& chain, const ChainParameters& chainParameters, const WetChainSettings& settings,
+    FloatType peak, FloatType& gain)
+{
+    auto isSettled = [](const auto& smoother, float target) { return !smoother.isSmoothing() && smoother.getTargetValue() == static_cast<FloatType>(target); };
+
+    if (!isSettled(chain.mix, chainParameters.mix)) {
+        return false;
+    }
+
+    if (chainParameters.mix == 0) {
+        gain = 1;
+        return true;
+    }
+
+    if (getPipeline<FloatType>().baseRateCrossover.isActive() || !isSettled(chain.drive, chainParameters.drive) || !isSettled(chain.outputGainPre, chainParameters.outputGainPre)) {
+        return false;
+    }
+
+    //the curves, with the offset they have at 0 taken off by the dc blocker, then the 2nd stage
+    FloatType offset = shapeSample(FloatType(0), settings.probeShapeStageIndex, settings.curve, FloatType(0));
+
+    auto driveSection = [&](FloatType x) {
+        FloatType y = shapeSample(x, settings.probeShapeStageIndex, settings.curve, offset);
+        FloatType previous = 0;
+        tanhStageTable<FloatType>[settings.probeTanhStageIndex](&y, 1, settings.tanh, previous);
+        return y;
+    };
+
+    FloatType drive = chain.drive.getTargetValue();
+    FloatType wetGain = chain.outputGainPre.getTargetValue() / drive * chain.mix.getTargetValue();
+    FloatType step = static_cast<FloatType>(LINEAR_PROBE_STEP);
+    FloatType slope = (driveSection(step) - driveSection(-step)) / (2 * step);
+    FloatType extent = peak * drive;
+    FloatType deviation = juce::jmax(std::abs(driveSection(extent) - slope * extent), std::abs(driveSection(-extent) + slope * extent));
+
+    if (deviation * wetGain > static_cast<FloatType>(LINEAR_TOLERANCE)) {
+        return false;
+    }
+
+    gain = wetGain * drive * slope + 1 - chain.mix.getTargetValue();
+    return true;
+}
+
+//the fast path, each awake channel is delayed by the chain's latency so switching paths doesn't move anything, then
+//given the gain and the final dc blocker. the gain goes from previousGain to gain over the block.
+template <typename FloatType>
+void THICCAudioProcessor::processBypass(OversampledChain<FloatType>& chain, juce::dsp::AudioBlock<FloatType> block, FloatType previousGain, FloatType gain,
+    bool isMetered)
+{
+    auto& pipeline = getPipeline<FloatType>();
+    LoadMeter::StageTimer stages(loadMeter);
+
+    int numSamples = static_cast<int>(block.getNumSamples());
+    int delay = juce::roundToInt(chain.latency);
+
+    FloatType inputPeakValue = inputPeak;
+    FloatType outputPeakValue = outputPeak;
+
+    for (int i = 0; i < pipeline.numAwakeChannels; i++) {
+        int channel = pipeline.awakeChannels[i];
+        FloatType* channelData = block.getChannelPointer(channel);
+        ChannelState<FloatType>& state = chain.channelStates[channel];
+
+        if (isMetered) {
+            peakStage(channelData, numSamples, inputPeakValue);
+        }
+
+        delayStage(channelData, numSamples, chain.bypassDelay.getWritePointer(channel), chain.bypassLength, delay);
+
+        if (previousGain != 1 || gain != 1) {
+            rampStage(channelData, numSamples, previousGain, gain);
+        }
+
+        if (isMetered) {
+            peakStage(channelData, numSamples, outputPeakValue);
+        }
+
+        dcBlockStage(channelData, numSamples, chain.outputDCCoefficient, state.bypassDCInput, state.bypassDCOutput);
+    }
+
+    inputPeak = static_cast<float>(inputPeakValue);
+    outputPeak = static_cast<float>(outputPeakValue);
+    stages.lap(LoadMeter::fastPath);
+}
+
+//runs task(0) to task(numTasks - 1), on the worker pool when that's allowed and there is more than one
+template <typename Function>
+void THICCAudioProcessor::runTasks(int numTasks, bool isParallel, Function& task)
+{
+    if (isParallel && numTasks > 1) {
+        workerPool.run(numTasks, task);
+    }
+    else {
+        for (int i = 0; i < numTasks; i++) {
+            task(i);
+        }
+    }
+}
+
+//runs everything at the oversampled rate after the band split, from drive to the mix. SampleType is either one channel
+//(FloatType) or a group of channels packed into a SIMD register, the state is laid out the same way.
+//each stage is its own loop over the whole block, which stages run is decided once here.
+template <typename FloatType, typename SampleType>
+void THICCAudioProcessor::processWetChain(const OversampledChain<FloatType>& chain, SampleType* samples, SampleType* dry, SampleType* otherBands, int numSamples, const WetChainSettings& settings,
+    ChannelState<SampleType>& state, LoadMeter::StageTimer& stages)
+{
+    //the dry signal for the mix is the band before drive
+    if (!settings.isMixedLater) {
+        std::copy(samples, samples + numSamples, dry);
+    }
+
+    //apply drive
+    gainStage(samples, chain.driveRamp.data(), numSamples);
+
+    //waveshape, with the kernels for the current settings
+    shapeStageTable<SampleType>[settings.shapeStageIndex](samples, numSamples, settings.curve, chain.dcCoefficient, state.dcInput, state.dcOutput, state.curveInputs);
+    tanhStageTable<SampleType>[settings.tanhStageIndex](samples, numSamples, settings.tanh, state.curveInputs[2]);
+
+    //reverse drive and apply output gain pre-mix
+    gainStage(samples, chain.postDriveRamp.data(), numSamples);
+
+    if (!settings.isMixedLater) {
+        //the antialiased curves delayed the band, the dry signal and other bands get the same delay
+        for (int i = 0; i < settings.numAntialiasedCurves; i++) {
+            halfSampleStage(dry, numSamples, state.dryInputs[i]);
+            if (otherBands != nullptr) {
+                halfSampleStage(otherBands, numSamples, state.otherBandsInputs[i]);
+            }
+        }
+
+        //apply mix, and add the other bands back in
+        mixStage(samples, dry, chain.mixRamp.data(), numSamples);
+
+        if (otherBands != nullptr) {
+            addStage(samples, otherBands, numSamples);
+        }
+    }
+
+    stages.lap(LoadMeter::shaping);
 }
 
 //==============================================================================
@@ -425,15 +1295,52 @@ juce::AudioProcessorEditor* THICCAudioProcessor::createEditor()
 }
 
 //==============================================================================
+//stable across platforms and JUCE versions, unlike String::hashCode, so it can go in saved states
+static juce::uint32 hashParameterID(const juce::String& parameterID) {
+    juce::uint32 hash = 2166136261u;
+
+    for (const char* character = parameterID.toRawUTF8(); *character != 0; character++) {
+        hash = (hash ^ static_cast<juce::uint8>(*character)) * 16777619u;
+    }
+    return hash;
+}
+
+//binary state: magic, version, then every parameter as the hash of its ID and its plain value, then the preset bank
+//with the values in the same order, then the current preset. later versions only add to the end.
+//a few hundred bytes, written without building a value tree or any XML.
 void THICCAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    juce::MemoryOutputStream stream(destData, false);
+    int numParameters = static_cast<int>(stateParameters.size());
+
+    stream.writeInt(STATE_MAGIC);
+    stream.writeInt(STATE_VERSION);
+
+    stream.writeInt(numParameters);
+    for (int i = 0; i < numParameters; i++) {
+        stream.writeInt(static_cast<int>(hashParameterID(stateParameters[i]->getParameterID())));
+        stream.writeFloat(rawParameters[i]->load());
+    }
+
+    int numPresets = presetBank.getNumPresets();
+    stream.writeInt(numPresets);
+    for (int preset = 0; preset < numPresets; preset++) {
+        stream.writeString(presetBank.getName(preset));
+        for (int i = 0; i < numParameters; i++) {
+            stream.writeFloat(presetBank.getValue(preset, i));
+        }
+    }
+
+    stream.writeInt(currentPreset.load());
 }
 
 void THICCAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    if (readBinaryState(data, sizeInBytes)) {
+        return;
+    }
+
+    //states saved before the binary format, as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
@@ -441,60 +1348,401 @@ void THICCAudioProcessor::setStateInformation (const void* data, int sizeInBytes
             parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
 }
 
-//==============================================================================
+//loads a state written by getStateInformation. returns false if the data isn't one, so it can be tried as XML.
+//the whole state is read and checked before anything is applied, so a truncated or corrupt one also returns false
+//and the current settings stay as they are.
+//parameters the state doesn't have go back to their defaults, ones this version doesn't know are skipped.
+bool THICCAudioProcessor::readBinaryState(const void* data, int sizeInBytes) {
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
 
-//input x, return function(x), where sampleData is x and type is the type of function to use.
-float THICCAudioProcessor::waveShape(float sampleData, int type, float softness, float knee, bool clipPeaks) {
-    bool isPositive = sampleData > 0;
-    float waveShapedData = abs(sampleData);
-    switch (type) {
-        case 1: //sin(x)
-            if (clipPeaks && waveShapedData >= (asin(1-knee) + knee)) {
-                waveShapedData = 1;
-            }
-            else if (waveShapedData > knee) {
-                waveShapedData = sin(waveShapedData - knee) + knee;
+    if (sizeInBytes < 12 || stream.readInt() != STATE_MAGIC || stream.readInt() < 1) {
+        return false;
+    }
+
+    //which of our parameters each stored value belongs to, -1 for the ones we don't have
+    int numParameters = static_cast<int>(stateParameters.size());
+    int numStored = stream.readInt();
+
+    //8 bytes for each parameter, then the preset count and the current preset
+    if (numStored < 0 || numStored > (stream.getNumBytesRemaining() - 8) / 8) {
+        return false;
+    }
+
+    std::vector<int> storedIndices(static_cast<size_t>(numStored), -1);
+    std::vector<float> defaults(static_cast<size_t>(numParameters));
+
+    for (int i = 0; i < numParameters; i++) {
+        defaults[i] = stateParameters[i]->convertFrom0to1(stateParameters[i]->getDefaultValue());
+    }
+
+    std::vector<float> values = defaults;
+    for (int stored = 0; stored < numStored; stored++) {
+        juce::uint32 hash = static_cast<juce::uint32>(stream.readInt());
+        float value = stream.readFloat();
+
+        if (!std::isfinite(value)) {
+            return false;
+        }
+
+        for (int i = 0; i < numParameters; i++) {
+            if (hashParameterID(stateParameters[i]->getParameterID()) == hash) {
+                storedIndices[stored] = i;
+                values[i] = value;
+                break;
             }
-            break; 
-        case 2: // -e^-x + 1
-            if (waveShapedData > knee) {
-                waveShapedData = -1 * exp((waveShapedData - knee) * -1) + knee + 1;
+        }
+    }
+
+    //the preset bank, in the same order as the parameters above. each preset is at least a name's terminator and its values
+    int numPresets = stream.readInt();
+    if (numPresets < 0 || numPresets > PresetBank::maxPresets || numPresets > (stream.getNumBytesRemaining() - 4) / (1 + 4 * numStored)) {
+        return false;
+    }
+
+    juce::StringArray presetNames;
+    std::vector<float> presetValues;
+    presetValues.reserve(static_cast<size_t>(numPresets * numParameters));
+
+    for (int preset = 0; preset < numPresets; preset++) {
+        presetNames.add(stream.readString());
+
+        //a name without its terminator runs to the end of the data
+        if (stream.getNumBytesRemaining() < numStored * 4 + 4) {
+            return false;
+        }
+
+        size_t first = presetValues.size();
+        presetValues.insert(presetValues.end(), defaults.begin(), defaults.end());
+        for (int stored = 0; stored < numStored; stored++) {
+            float value = stream.readFloat();
+
+            if (!std::isfinite(value)) {
+                return false;
             }
-            break;
-        case 3: // ln(x+1)
-            if (waveShapedData > knee) {
-                waveShapedData = log(waveShapedData - knee + 1) + knee;
+            if (storedIndices[stored] >= 0) {
+                presetValues[first + storedIndices[stored]] = value;
             }
-            break;
-        case 4: //tanh(x)
-            if (waveShapedData > knee) {
-                waveShapedData = tanh(waveShapedData - knee) + knee;
+        }
+    }
+
+    int preset = stream.readInt();
+    if (preset < 0 || preset >= juce::jmax(1, numPresets)) {
+        return false;
+    }
+
+    //all of it is good, so it replaces the current state
+    for (int i = 0; i < numParameters; i++) {
+        setParameterValue(i, values[i]);
+    }
+
+    presetBank.clear();
+    for (int i = 0; i < numPresets; i++) {
+        presetBank.add(presetNames[i], presetValues.data() + i * numParameters);
+    }
+
+    currentPreset.store(preset);
+    return true;
+}
+
+//==============================================================================
+
+//builds everything that runs at the oversampled rate, never called on the audio thread
+template <typename FloatType>
+std::unique_ptr<THICCAudioProcessor::OversampledChain<FloatType>> THICCAudioProcessor::createChain(int factor, bool linearPhase) {
+    auto chain = std::make_unique<OversampledChain<FloatType>>();
+    int totalNumInputChannels = numChannels;
+    int OSMultiplier = 1 << factor;
+
+    chain->factor = factor;
+    chain->isLinearPhase = linearPhase;
+    chain->dcCoefficient = static_cast<FloatType>(getDCBlockCoefficient(currentSampleRate * OSMultiplier));
+    chain->outputDCCoefficient = static_cast<FloatType>(getDCBlockCoefficient(currentSampleRate));
+
+    //IIR polyphase is cheap but not phase linear, FIR equiripple is phase linear with a lot more latency.
+    //both are built with integer latency so the host can compensate exactly.
+    auto filterType = linearPhase ? juce::dsp::Oversampling<FloatType>::FilterType::filterHalfBandFIREquiripple
+        : juce::dsp::Oversampling<FloatType>::FilterType::filterHalfBandPolyphaseIIR;
+
+    //a bus with no channels still gets one, for the latency
+    chain->oversampler = std::make_unique<juce::dsp::Oversampling<FloatType>>(juce::jmax(1, totalNumInputChannels), factor, filterType, true, true);
+    chain->oversampler->initProcessing(maxBlockSize);
+    chain->latency = chain->oversampler->getLatencyInSamples();
+
+    struct juce::dsp::ProcessSpec processSpec = { currentSampleRate * OSMultiplier, static_cast<juce::uint32>(maxBlockSize * OSMultiplier),
+        static_cast<juce::uint32>(totalNumInputChannels) };
+
+    chain->crossover.prepare(processSpec, *lowPassParameter, *highPassParameter);
+
+    //gain smoothing, snapped to the current values so the chain doesn't start with a ramp
+    chain->drive.reset(currentSampleRate * OSMultiplier, SMOOTHING_TIME);
+    chain->outputGainPre.reset(currentSampleRate * OSMultiplier, SMOOTHING_TIME);
+    chain->mix.reset(currentSampleRate * OSMultiplier, SMOOTHING_TIME);
+
+    chain->drive.setCurrentAndTargetValue(std::pow(FloatType(10), *driveParameter * FloatType(0.05)));
+    chain->outputGainPre.setCurrentAndTargetValue(std::pow(FloatType(10), *outputGainPreParameter * FloatType(0.05)));
+    chain->mix.setCurrentAndTargetValue(*mixParameter / FloatType(100));
+
+    //multirate band delays
+    struct juce::dsp::ProcessSpec baseRateSpec = { currentSampleRate, static_cast<juce::uint32>(maxBlockSize), static_cast<juce::uint32>(totalNumInputChannels) };
+
+    FloatType OSLatency = chain->latency;
+    int maxBandDelay = static_cast<int>(std::ceil(OSLatency)) + 4;
+
+    chain->mainBandDelay.setMaximumDelayInSamples(maxBandDelay);
+    chain->otherBandsDelay.setMaximumDelayInSamples(maxBandDelay);
+    chain->mainBandDelay.prepare(baseRateSpec);
+    chain->otherBandsDelay.prepare(baseRateSpec);
+    chain->mainBandDelay.setDelay(OSLatency);
+    chain->otherBandsDelay.setDelay(OSLatency);
+
+    chain->channelStates.assign(totalNumInputChannels, ChannelState<FloatType>());
+
+    //scratch for this factor only
+    int OSBlockSize = maxBlockSize * OSMultiplier;
+
+    chain->maxOSBlockSize = OSBlockSize;
+    chain->driveRamp.assign(OSBlockSize, FloatType(1));
+    chain->postDriveRamp.assign(OSBlockSize, FloatType(1));
+    chain->mixRamp.assign(OSBlockSize, FloatType(1));
+
+    chain->otherBandsOSBuffer.setSize(totalNumInputChannels, OSBlockSize);
+    chain->bypassLength = 2 * juce::roundToInt(OSLatency) + juce::roundToInt(currentSampleRate * WARM_UP_TIME);
+    chain->bypassDelay.setSize(totalNumInputChannels, chain->bypassLength + maxBlockSize);
+    chain->bypassDelay.clear();
+    chain->upChannels.assign(totalNumInputChannels, nullptr);
+    chain->downChannels.assign(totalNumInputChannels, nullptr);
+    chain->silence.assign(maxBlockSize, FloatType(0));
+    chain->droppedOutput.assign(maxBlockSize, FloatType(0));
+    chain->awakeOSChannels.assign(totalNumInputChannels, nullptr);
+    chain->awakeOtherBands.assign(totalNumInputChannels, nullptr);
+
+    //one stretch per group of channels
+    int laneCount = static_cast<int>(SIMDHelpers::Register<FloatType>::size());
+    int numGroups = (totalNumInputChannels + laneCount - 1) / laneCount;
+
+    chain->interleavedBlock.resize(OSBlockSize * numGroups);
+    chain->interleavedOtherBands.resize(OSBlockSize * numGroups);
+    chain->dryBlock.resize(OSBlockSize * numGroups);
+    chain->interleavedDry.resize(OSBlockSize * numGroups);
+    chain->inputPeaks.assign(totalNumInputChannels, FloatType(0));
+    chain->outputPeaks.assign(totalNumInputChannels, FloatType(0));
+
+    return chain;
+}
+
+template <typename FloatType>
+void THICCAudioProcessor::resetChain(OversampledChain<FloatType>& chain) {
+    chain.oversampler->reset();
+    chain.crossover.reset();
+    chain.mainBandDelay.reset();
+    chain.otherBandsDelay.reset();
+    chain.bypassDelay.clear();
+
+    std::fill(chain.channelStates.begin(), chain.channelStates.end(), ChannelState<FloatType>());
+}
+
+//clears what the chain held from before the fast path took over, so it starts again from silence. the dc blockers
+//after the curves start settled on the offset the curves have at 0, so nothing steps when the chain comes back,
+//and the final dc blockers pick up from the fast path's. safe on the audio thread.
+template <typename FloatType>
+void THICCAudioProcessor::resumeChain(OversampledChain<FloatType>& chain, FloatType curveOffset) {
+    chain.oversampler->reset();
+    chain.crossover.reset();
+    chain.mainBandDelay.reset();
+    chain.otherBandsDelay.reset();
+
+    for (auto& state : chain.channelStates) {
+        ChannelState<FloatType> resumed;
+        resumed.dcInput = curveOffset;
+        resumed.dcInput2 = state.bypassDCInput;
+        resumed.dcOutput2 = state.bypassDCOutput;
+        resumed.bypassDCInput = state.bypassDCInput;
+        resumed.bypassDCOutput = state.bypassDCOutput;
+        state = resumed;
+    }
+}
+
+//runs a resumed chain over up to maxNumSamples of the input the fast path's delay line holds that it hasn't seen yet,
+//so its oversampler, curves and dc blockers end up where they would be had the chain never stopped. the output is
+//thrown away and the gain ramps are put back. called once a block until warmUpSamplesBehind is 0, which keeps the
+//cost of any one block to that of a factor switch.
+template <typename FloatType>
+void THICCAudioProcessor::warmUpChain(OversampledChain<FloatType>& chain, const ChainParameters& chainParameters, WetChainSettings settings, int maxNumSamples) {
+    auto& pipeline = getPipeline<FloatType>();
+    auto drive = chain.drive;
+    auto outputGainPre = chain.outputGainPre;
+    auto mix = chain.mix;
+    settings.isMetered = false;
+
+    //multirate splits the bands before the chain, so the host rate crossover is brought along too
+    bool isSplitAtBaseRate = chainParameters.isMultirate && pipeline.baseRateCrossover.isActive();
+    if (isSplitAtBaseRate && !pipeline.wasBaseRateCrossoverRunning) {
+        pipeline.baseRateCrossover.reset();
+        pipeline.wasBaseRateCrossoverRunning = true;
+    }
+
+    int end = chain.bypassLength - pipeline.warmUpSamplesBehind + juce::jmin(maxNumSamples, pipeline.warmUpSamplesBehind);
+    for (int start = chain.bypassLength - pipeline.warmUpSamplesBehind; start < end; start += pipeline.fadeBuffer.getNumSamples()) {
+        int numSamples = juce::jmin(pipeline.fadeBuffer.getNumSamples(), end - start);
+
+        for (int i = 0; i < pipeline.numAwakeChannels; i++) {
+            int channel = pipeline.awakeChannels[i];
+            pipeline.fadeBuffer.copyFrom(channel, 0, chain.bypassDelay, channel, start, numSamples);
+
+            if (isSplitAtBaseRate) {
+                pipeline.mainBandBuffer.copyFrom(channel, 0, chain.bypassDelay, channel, start, numSamples);
+                pipeline.baseRateCrossover.processBlock(channel, pipeline.mainBandBuffer.getWritePointer(channel), pipeline.otherBandsBuffer.getWritePointer(channel), numSamples);
             }
-            break;
-        default:
-            waveShapedData = 0;
+        }
+        processChain(chain, juce::dsp::AudioBlock<FloatType>(pipeline.fadeBuffer).getSubBlock(0, static_cast<size_t>(numSamples)), chainParameters, settings);
+    }
+    pipeline.warmUpSamplesBehind = chain.bypassLength - end;
+
+    chain.drive = drive;
+    chain.outputGainPre = outputGainPre;
+    chain.mix = mix;
+}
+
+//clears what one channel left in its dc blockers when it goes to sleep. the oversampler, crossover and band delays
+//are shared by every channel and can't be cleared for one, but the channel's part has died away by then, and the
+//oversampler is fed silence for it until it wakes. the dc blocker after the curves starts settled on their offset at 0,
+//as in resumeChain, so waking doesn't thump. safe on the audio thread, nothing is allocated.
+template <typename FloatType>
+void THICCAudioProcessor::resetChannel(OversampledChain<FloatType>& chain, int channel, FloatType curveOffset) {
+    chain.channelStates[channel] = ChannelState<FloatType>();
+    chain.channelStates[channel].dcInput = curveOffset;
+    chain.bypassDelay.clear(channel, 0, chain.bypassDelay.getNumSamples());
+}
+
+void THICCAudioProcessor::reportLatency(double latency) {
+    setLatencySamples(juce::roundToInt(latency));
+
+    //the oversampling filters ring on for about as long again as their latency, then the dc blockers settle
+    tailLengthSeconds = (2 * latency + getDCBlockTailSamples(currentSampleRate)) / currentSampleRate;
+}
+
+//builds a chain when the oversampling factor or filter changes, and deletes the one it replaced.
+//the audio thread only ever swaps pointers.
+void THICCAudioProcessor::timerCallback() {
+    //nothing has been processed since the last tick, so a recalled preset is applied here instead of at the next block
+    juce::uint32 numBlocks = numBlocksProcessed.load(std::memory_order_relaxed);
+    if (numBlocks == lastNumBlocksProcessed) {
+        int preset = pendingPreset.exchange(-1);
+        if (preset >= 0) {
+            applyPreset(preset);
+        }
+    }
+    lastNumBlocksProcessed = numBlocks;
+
+    //the audio thread has switched the raw values to a preset, the parameters catch up so the host and editor follow
+    if (appliedPreset.exchange(-1) >= 0) {
+        for (int i = 0; i < static_cast<int>(stateParameters.size()); i++) {
+            setParameterValue(i, rawParameters[i]->load());
+        }
+        updateHostDisplay();
+    }
+
+    //the host only compensates for a new latency once the audio thread has switched to the chain that has it,
+    //which waits while a switch, a fade or the fast path is still going
+    double latency = swappedLatency.exchange(-1);
+    if (latency >= 0) {
+        reportLatency(latency);
+    }
+
+    const juce::ScopedLock lock(chainLock);
+
+    if (isDoublePrecision) {
+        updateChain<double>();
+    }
+    else {
+        updateChain<float>();
     }
-    if (clipPeaks) {
-        waveShapedData = fminf(waveShapedData, 1);
+}
+
+template <typename FloatType>
+void THICCAudioProcessor::updateChain() {
+    auto& pipeline = getPipeline<FloatType>();
+
+    delete pipeline.retiredChain.exchange(nullptr);
+
+    int factor = static_cast<int>(std::roundf(*OSFactorParameter)) - 1;
+    bool linearPhase = *linearPhaseParameter > 0.5f;
+
+    if (maxBlockSize == 0 || pipeline.pendingChain.load() != nullptr || (factor == requestedFactor && linearPhase == requestedLinearPhase)) {
+        return;
+    }
+
+    auto chain = createChain<FloatType>(factor, linearPhase);
+
+    requestedFactor = factor;
+    requestedLinearPhase = linearPhase;
+    pipeline.pendingChain.store(chain.release());
+}
+
+//the peak frames for the waveform display, only the editor reads from it
+PeakFrameQueue& THICCAudioProcessor::getPeakFrameQueue() {
+    return peakFrames;
+}
+
+//block and stage timings for the editor's overlay and the tool, empty unless THICC_LOAD_METER is set
+LoadMeter& THICCAudioProcessor::getLoadMeter() {
+    return loadMeter;
+}
+
+PresetBank& THICCAudioProcessor::getPresetBank() {
+    return presetBank;
+}
+
+//adds the current settings to the preset bank, message thread. returns the index, or -1 if the bank is full
+int THICCAudioProcessor::storePreset(const juce::String& name) {
+    std::vector<float> values;
+    for (auto* rawParameter : rawParameters) {
+        values.push_back(rawParameter->load());
     }
-    
-    waveShapedData = softness * waveShapedData + (1 - softness) * fminf(abs(sampleData), 1);
 
-    if (!isPositive) {
-        waveShapedData *= -1;
+    int preset = presetBank.add(name, values.data());
+    if (preset >= 0) {
+        currentPreset.store(preset);
+        updateHostDisplay();
     }
+    return preset;
+}
 
-    return waveShapedData;
+//switches to a preset, from any thread including the audio thread, without waiting or allocating.
+//the next block applies every value at once, and the timer then updates the parameters
+void THICCAudioProcessor::recallPreset(int index) {
+    if (index >= 0 && index < presetBank.getNumPresets()) {
+        pendingPreset.store(index);
+    }
 }
 
-//returns an array of the peak values of the input audio
-float* THICCAudioProcessor::getInputPeakArr() {
-    return inputPeakArr;
+//writes a preset straight into the raw values the audio thread reads, no parameter listeners are called
+void THICCAudioProcessor::applyPreset(int index) {
+    if (index >= presetBank.getNumPresets()) {
+        return;
+    }
+
+    for (size_t i = 0; i < rawParameters.size(); i++) {
+        rawParameters[i]->store(presetBank.getValue(index, static_cast<int>(i)));
+    }
+
+    currentPreset.store(index);
+    appliedPreset.store(index);
+}
+
+//sets a parameter to a plain value on the message thread, the host and listeners only hear about it if it changed
+void THICCAudioProcessor::setParameterValue(int index, float value) {
+    juce::RangedAudioParameter* parameter = stateParameters[index];
+    float normalisedValue = parameter->convertTo0to1(value);
+
+    if (normalisedValue != parameter->getValue() || value != rawParameters[index]->load()) {
+        parameter->setValueNotifyingHost(normalisedValue);
+    }
 }
 
-//returns an array of the peak values of the output audio
-float* THICCAudioProcessor::getOutputPeakArr() {
-    return outputPeakArr;
+//the editor turns metering on while it is open, the audio thread skips the peak stages otherwise
+void THICCAudioProcessor::setMeteringEnabled(bool isEnabled) {
+    isMeteringEnabled.store(isEnabled);
 }
 
 //returns the array size of the peak volume data array
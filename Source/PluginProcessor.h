@@ -9,11 +9,19 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Crossover.h"
+#include "LoadMeter.h"
+#include "PeakFrameQueue.h"
+#include "PresetBank.h"
+#include "SIMDHelpers.h"
+#include "WaveShaper.h"
+#include "WorkerPool.h"
 
 //==============================================================================
 /**
 */
-class THICCAudioProcessor  : public juce::AudioProcessor
+class THICCAudioProcessor  : public juce::AudioProcessor,
+                             private juce::Timer
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
@@ -32,6 +40,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,8 +66,14 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     
-    float* getInputPeakArr();
-    float* getOutputPeakArr();
+    //in-memory presets, which the host also sees as programs
+    PresetBank& getPresetBank();
+    int storePreset(const juce::String& name);
+    void recallPreset(int index);
+
+    PeakFrameQueue& getPeakFrameQueue();
+    LoadMeter& getLoadMeter();
+    void setMeteringEnabled(bool isEnabled);
 
     int getVolArraySize();
 
@@ -83,41 +99,277 @@ private:
     std::atomic<float>* evenParameter = nullptr;
 
     std::atomic<float>* OSFactorParameter = nullptr;
+    std::atomic<float>* multirateParameter = nullptr;
+    std::atomic<float>* ecoParameter = nullptr;
+    std::atomic<float>* linearPhaseParameter = nullptr;
+    std::atomic<float>* antialiasingParameter = nullptr;
+
+    //every parameter in the host's order with its raw value, for the state and the preset bank
+    std::vector<juce::RangedAudioParameter*> stateParameters;
+    std::vector<std::atomic<float>*> rawParameters;
+
+    PresetBank presetBank;
+    std::atomic<int> currentPreset { 0 };
+    std::atomic<int> pendingPreset { -1 }; //recalled, waiting for the start of the next block
+    std::atomic<int> appliedPreset { -1 }; //in the raw values, waiting for the timer to pass it on to the parameters
+
+    //blocks processed, so the timer can tell when the audio thread isn't running
+    std::atomic<juce::uint32> numBlocksProcessed { 0 };
+    juce::uint32 lastNumBlocksProcessed = 0;
+
+    //state carried from block to block for one channel, cache line aligned. FloatType can also be a register,
+    //for a group of channels with one lane each
+    template <typename FloatType>
+    struct alignas(64) ChannelState {
+        //dc blocker variables, after the curves at the oversampled rate
+        FloatType dcOutput = 0;
+        FloatType dcInput = 0;
+
+        //the final dc blocker, at the host rate. unused by groups
+        FloatType dcOutput2 = 0;
+        FloatType dcInput2 = 0;
+
+        //the fast path's own final dc blocker, both run while the paths crossfade. unused by groups
+        FloatType bypassDCOutput = 0;
+        FloatType bypassDCInput = 0;
+
+        //antialiasing, the last input of each curve (up to 3), and of the half sample delays on the dry signal and other bands
+        FloatType curveInputs[3] = {};
+        FloatType dryInputs[3] = {};
+        FloatType otherBandsInputs[3] = {};
+    };
+
+    //a channel sleeps once its input has gone quiet and its tail has died away, and is skipped until the input comes back
+    struct ChannelGate {
+        int quietSamples = 0; //since the input was last above the threshold, counted while awake
+        bool isAsleep = true;
+    };
+
+    //everything that depends on the oversampling factor. when the factor changes a new chain is built
+    //off the audio thread, and the audio thread crossfades from the old one to it.
+    template <typename FloatType>
+    struct OversampledChain {
+        int factor; //2^factor times oversampling
+        bool isLinearPhase;
+
+        //one for every channel of the bus, so its filters are only designed once per chain
+        std::unique_ptr<juce::dsp::Oversampling<FloatType>> oversampler;
+        FloatType latency; //of the oversampler, in samples at the host rate
+        FloatType dcCoefficient; //for the dc blocker after the curves, at the oversampled rate
+        FloatType outputDCCoefficient; //for the final dc blocker, at the host rate
+        Crossover<FloatType> crossover;
+
+        juce::SmoothedValue<FloatType, juce::ValueSmoothingTypes::Multiplicative> drive;
+        juce::SmoothedValue<FloatType, juce::ValueSmoothingTypes::Multiplicative> outputGainPre;
+        juce::SmoothedValue<FloatType> mix;
+
+        //multirate, the bypassed bands are delayed by the oversampler latency so they line up with the processed band
+        juce::dsp::DelayLine<FloatType, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> mainBandDelay;
+        juce::dsp::DelayLine<FloatType, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> otherBandsDelay;
+        bool wasSplitAtBaseRate = false;
+
+        //one per channel of the bus
+        std::vector<ChannelState<FloatType>> channelStates;
+
+        //scratch, sized for this chain's factor when it is built
+        int maxOSBlockSize;
+
+        //per-sample gain ramps for the oversampled block, filled once per block
+        std::vector<FloatType> driveRamp;
+        std::vector<FloatType> postDriveRamp;
+        std::vector<FloatType> mixRamp;
+
+        //band split output at the oversampled rate
+        juce::AudioBuffer<FloatType> otherBandsOSBuffer;
+
+        //the fast path's delay, the last bypassLength samples of input of each channel with room for a block after them.
+        //it keeps twice the latency and a bit more, for warming the chain back up when it takes over again
+        juce::AudioBuffer<FloatType> bypassDelay;
+        int bypassLength = 0;
+
+        //what the oversampler reads from and writes back to for each channel of the bus. a sleeping channel is given
+        //silence going up and scratch coming down, so its input stays as it is
+        std::vector<const FloatType*> upChannels;
+        std::vector<FloatType*> downChannels;
+        std::vector<FloatType> silence;
+        std::vector<FloatType> droppedOutput;
+
+        //the oversampled block and band split output of each awake channel, in the order of Pipeline::awakeChannels
+        std::vector<FloatType*> awakeOSChannels;
+        std::vector<FloatType*> awakeOtherBands;
+
+        //a group of up to SIMDRegister::size() channels packed into one register per sample.
+        //every group has its own maxOSBlockSize long stretch, so groups can run on different threads
+        std::vector<SIMDHelpers::Register<FloatType>> interleavedBlock;
+        std::vector<SIMDHelpers::Register<FloatType>> interleavedOtherBands;
+
+        //copies of the band before drive, for the mix stage
+        std::vector<FloatType> dryBlock;
+        std::vector<SIMDHelpers::Register<FloatType>> interleavedDry;
+
+        //peaks of each awake channel or group for the block, combined once they have all finished
+        std::vector<FloatType> inputPeaks;
+        std::vector<FloatType> outputPeaks;
+    };
+
+    //everything the audio thread touches at one precision. only the precision the host
+    //prepared for holds any chains or buffers, the other one stays empty.
+    template <typename FloatType>
+    struct Pipeline {
+        //smoothed gains at the host rate, the ones inside the oversampled chain are in OversampledChain
+        juce::SmoothedValue<FloatType, juce::ValueSmoothingTypes::Multiplicative> inputGain;
+        juce::SmoothedValue<FloatType, juce::ValueSmoothingTypes::Multiplicative> outputGainPost;
+
+        std::unique_ptr<OversampledChain<FloatType>> activeChain;
+        std::unique_ptr<OversampledChain<FloatType>> fadingChain; //the previous chain, while it fades out
+
+        //handed between the audio thread and the message thread, at most one of each at a time
+        std::atomic<OversampledChain<FloatType>*> pendingChain { nullptr };
+        std::atomic<OversampledChain<FloatType>*> retiredChain { nullptr };
+
+        int fadeSamplesRemaining = 0;
+        juce::AudioBuffer<FloatType> fadeBuffer; //what is fading out, the old chain or the path being left
 
-    //filters
-    juce::dsp::LinkwitzRileyFilter<float> highPassHigh;
-    juce::dsp::LinkwitzRileyFilter<float> highPassHigh2;
-    juce::dsp::LinkwitzRileyFilter<float> lowPassLow;
-    juce::dsp::LinkwitzRileyFilter<float> lowPassLow2;
-    juce::dsp::LinkwitzRileyFilter<float> highPassMid;
-    juce::dsp::LinkwitzRileyFilter<float> lowPassMid;
+        //dry and linear blocks skip the chain for a delay and a gain
+        bool isBypassed = false;
+        bool isBypassDry = false; //taken over for a dry chain rather than linear blocks
+        bool isBypassFading = false; //fadeSamplesRemaining is for switching paths, not factors
+        int linearSamples = 0; //since the input was last too loud for the fast path
+        int warmUpSamplesBehind = 0; //input in the fast path's delay the chain still has to run over after a linear stretch
+        FloatType bypassGain = 1;
 
-    //dc blocker variables
-    float* dcOutput;
-    float* dcInput;
+        //multirate band split, the crossover runs at the host rate and only the main band is oversampled
+        Crossover<FloatType> baseRateCrossover;
 
-    float* dcOutput2;
-    float* dcInput2;
+        juce::AudioBuffer<FloatType> mainBandBuffer;
+        juce::AudioBuffer<FloatType> otherBandsBuffer;
+
+        bool wasBaseRateCrossoverRunning = false;
+
+        //silence detection, one gate per channel. the channels that are processed this block are listed in awakeChannels
+        std::vector<ChannelGate> gates;
+        std::vector<int> awakeChannels;
+        int numAwakeChannels = 0;
+    };
+
+    Pipeline<float> floatPipeline;
+    Pipeline<double> doublePipeline;
+
+    //what the newest chain was built for, only touched off the audio thread
+    int requestedFactor = -1;
+    bool requestedLinearPhase = false;
+    juce::CriticalSection chainLock;
+
+    int fadeLength = 0;
+
+    double currentSampleRate = 0;
+    int maxBlockSize = 0;
+    int numChannels = 0; //channels on the bus at prepare time, every chain is sized for this many
+    bool isDoublePrecision = false; //which pipeline the host prepared for
 
     //volume display vars
     int volCounter;
     int volCounterMax;
 
-    float* inputPeakArr;
-    float* outputPeakArr;
+    PeakFrameQueue peakFrames;
+    std::atomic<bool> isMeteringEnabled { false }; //only while an editor is open
+    bool wasMetering = false;
+
+    //block and stage timings, compiled out unless THICC_LOAD_METER is set
+    LoadMeter loadMeter;
 
     float inputPeak = 0;
     float outputPeak = 0;
 
-    //oversampling
-    std::unique_ptr<juce::dsp::Oversampling<float>> OSProcessor[5];
+    double tailLengthSeconds = 0;
+    std::atomic<double> swappedLatency { -1 }; //of a chain the audio thread has switched to, waiting for the timer to report it
 
-    int OSFactor;
+    //spreads the channels of a block over several threads, only started for offline renders
+    WorkerPool workerPool;
 
-    bool resetFlag;
+    //waveshaping settings for the current block
+    struct WetChainSettings {
+        int shapeStageIndex; //kernels for the current curve and flags
+        int tanhStageIndex;
+        int numAntialiasedCurves; //0 when antialiasing is off
+        int probeShapeStageIndex; //the same kernels without antialiasing, for the fast path to try single samples on
+        int probeTanhStageIndex;
+        WaveShaper::Settings curve; //drive section, no knee
+        WaveShaper::Settings tanh; //2nd stage
+        bool isMixedLater; //multirate mode, only the wet band is produced
+        bool isMetered;
+    };
+
+    //targets for the smoothers and filters inside the chain
+    struct ChainParameters {
+        float lowPass;
+        float highPass;
+        float drive;
+        float outputGainPre;
+        float mix;
+        bool isMultirate;
+    };
 
     //==============================================================================
-    float waveShape(float sampleData, int type, float softness, float knee, bool clipPeaks);
+    template <typename FloatType>
+    Pipeline<FloatType>& getPipeline();
+
+    template <typename FloatType>
+    void preparePipeline(double sampleRate, int samplesPerBlock);
+
+    template <typename FloatType>
+    void releasePipeline();
+
+    template <typename FloatType>
+    void resetPipeline();
+
+    template <typename FloatType>
+    std::unique_ptr<OversampledChain<FloatType>> createChain(int factor, bool linearPhase);
+
+    template <typename FloatType>
+    void resetChain(OversampledChain<FloatType>& chain);
+
+    template <typename FloatType>
+    void resetChannel(OversampledChain<FloatType>& chain, int channel, FloatType curveOffset);
+
+    template <typename FloatType>
+    void resumeChain(OversampledChain<FloatType>& chain, FloatType curveOffset);
+
+    template <typename FloatType>
+    void warmUpChain(OversampledChain<FloatType>& chain, const ChainParameters& chainParameters, WetChainSettings settings, int maxNumSamples);
+
+    void reportLatency(double latency);
+
+    template <typename FloatType>
+    void updateChain();
+
+    void timerCallback() override;
+
+    void applyPreset(int index);
+    void setParameterValue(int index, float value);
+    bool readBinaryState(const void* data, int sizeInBytes);
+
+    template <typename FloatType>
+    void process(juce::AudioBuffer<FloatType>& buffer);
+
+    template <typename FloatType>
+    void processPiece(juce::AudioBuffer<FloatType>& buffer);
+
+    template <typename FloatType>
+    void processChain(OversampledChain<FloatType>& chain, juce::dsp::AudioBlock<FloatType> block, const ChainParameters& chainParameters, WetChainSettings settings);
+
+    template <typename FloatType>
+    bool getBypassGain(const OversampledChain<FloatType>& chain, const ChainParameters& chainParameters, const WetChainSettings& settings, FloatType peak, FloatType& gain);
+
+    template <typename FloatType>
+    void processBypass(OversampledChain<FloatType>& chain, juce::dsp::AudioBlock<FloatType> block, FloatType previousGain, FloatType gain, bool isMetered);
+
+    template <typename Function>
+    void runTasks(int numTasks, bool isParallel, Function& task);
+
+    template <typename FloatType, typename SampleType>
+    void processWetChain(const OversampledChain<FloatType>& chain, SampleType* samples, SampleType* dry, SampleType* otherBands, int numSamples, const WetChainSettings& settings,
+        ChannelState<SampleType>& state, LoadMeter::StageTimer& stages);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (THICCAudioProcessor)
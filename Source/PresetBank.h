@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 18 Oct 2026 11:57:02pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//presets kept in memory as one plain value per parameter, in the processor's parameter order. presets are added,
+//replaced and named on the message thread, and read from any thread. every value is its own atomic, so the audio
+//thread can copy a preset out while it is being replaced without waiting, it just may get some of each. the names
+//are only ever read off the audio thread, hosts ask for them from their own threads, so they sit behind a spin lock.
+class PresetBank {
+public:
+    static constexpr int maxPresets = 128;
+
+    //message thread, once the parameters exist. all the storage is allocated here
+    void prepare(int parameterCount) {
+        numParameters = parameterCount;
+        values.reset(new std::atomic<float>[static_cast<size_t>(maxPresets * numParameters)]);
+        numPresets.store(0);
+
+        const juce::SpinLock::ScopedLockType lock(namesLock);
+        names.clearQuick();
+        names.ensureStorageAllocated(maxPresets);
+    }
+
+    int getNumParameters() const {
+        return numParameters;
+    }
+
+    //any thread
+    int getNumPresets() const {
+        return numPresets.load();
+    }
+
+    //any thread, preset and parameter must be in range
+    float getValue(int preset, int parameter) const {
+        jassert(preset >= 0 && preset < getNumPresets() && parameter >= 0 && parameter < numParameters);
+        return values[preset * numParameters + parameter].load(std::memory_order_relaxed);
+    }
+
+    //any thread but the audio thread, empty when preset is out of range
+    juce::String getName(int preset) const {
+        const juce::SpinLock::ScopedLockType lock(namesLock);
+        return names[preset];
+    }
+
+    //message thread
+    void setName(int preset, const juce::String& name) {
+        const juce::SpinLock::ScopedLockType lock(namesLock);
+        if (preset >= 0 && preset < getNumPresets()) {
+            names.set(preset, name);
+        }
+    }
+
+    //message thread, adds a preset with a value for every parameter. returns its index, or -1 if the bank is full
+    int add(const juce::String& name, const float* presetValues) {
+        int preset = getNumPresets();
+        if (preset == maxPresets) {
+            return -1;
+        }
+
+        {
+            const juce::SpinLock::ScopedLockType lock(namesLock);
+            names.add(name);
+        }
+        storeValues(preset, presetValues);
+
+        //published last, so a reader never sees a preset before its values
+        numPresets.store(preset + 1);
+        return preset;
+    }
+
+    //message thread
+    void replace(int preset, const float* presetValues) {
+        if (preset >= 0 && preset < getNumPresets()) {
+            storeValues(preset, presetValues);
+        }
+    }
+
+    //message thread. the storage stays, so a reader that is copying a preset out still reads valid values
+    void clear() {
+        numPresets.store(0);
+
+        const juce::SpinLock::ScopedLockType lock(namesLock);
+        names.clearQuick();
+    }
+
+private:
+    void storeValues(int preset, const float* presetValues) {
+        for (int parameter = 0; parameter < numParameters; parameter++) {
+            values[preset * numParameters + parameter].store(presetValues[parameter], std::memory_order_relaxed);
+        }
+    }
+
+    int numParameters = 0;
+    std::unique_ptr<std::atomic<float>[]> values;
+    juce::StringArray names;
+    juce::SpinLock namesLock; //held only to copy, set, add or clear a name
+    std::atomic<int> numPresets { 0 };
+};
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    SIMDHelpers.h
+    Created: 18 Oct 2026 4:02:37pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//lets the same processing code run on a single channel (float or double) or on several channels
+//packed into the lanes of a SIMD register, one register per sample.
+namespace SIMDHelpers {
+    template <typename FloatType>
+    using Register = juce::dsp::SIMDRegister<FloatType>;
+
+    using FloatRegister = Register<float>;
+    using DoubleRegister = Register<double>;
+
+    //the scalar type of one channel, or of one lane of a register
+    template <typename SampleType>
+    struct ElementTypeOf {
+        using Type = SampleType;
+    };
+
+    template <typename FloatType>
+    struct ElementTypeOf<Register<FloatType>> {
+        using Type = FloatType;
+    };
+
+    template <typename SampleType>
+    using ElementType = typename ElementTypeOf<SampleType>::Type;
+
+    inline float abs(float x) {
+        return std::abs(x);
+    }
+
+    inline double abs(double x) {
+        return std::abs(x);
+    }
+
+    template <typename FloatType>
+    Register<FloatType> abs(Register<FloatType> x) {
+        return Register<FloatType>::abs(x);
+    }
+
+    inline float max(float a, float b) {
+        return juce::jmax(a, b);
+    }
+
+    inline double max(double a, double b) {
+        return juce::jmax(a, b);
+    }
+
+    template <typename FloatType>
+    Register<FloatType> max(Register<FloatType> a, Register<FloatType> b) {
+        return Register<FloatType>::max(a, b);
+    }
+
+    inline float min(float a, float b) {
+        return juce::jmin(a, b);
+    }
+
+    inline double min(double a, double b) {
+        return juce::jmin(a, b);
+    }
+
+    template <typename FloatType>
+    Register<FloatType> min(Register<FloatType> a, Register<FloatType> b) {
+        return Register<FloatType>::min(a, b);
+    }
+
+    //x in every lane, or just x for a single channel
+    template <typename SampleType>
+    SampleType expand(ElementType<SampleType> x) {
+        if constexpr (std::is_floating_point_v<SampleType>) {
+            return x;
+        }
+        else {
+            return SampleType::expand(x);
+        }
+    }
+
+    //the bits of each lane as an unsigned integer, and back
+    template <typename FloatType>
+    typename Register<FloatType>::vMaskType toBits(Register<FloatType> x) {
+        typename Register<FloatType>::vMaskType bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    template <typename FloatType>
+    Register<FloatType> fromBits(typename Register<FloatType>::vMaskType bits) {
+        Register<FloatType> x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    //returns ifGreater where a > b and otherwise elsewhere. a register picks each lane with a mask, so
+    //both sides are worked out for every lane
+    inline float selectGreater(float a, float b, float ifGreater, float otherwise) {
+        return a > b ? ifGreater : otherwise;
+    }
+
+    inline double selectGreater(double a, double b, double ifGreater, double otherwise) {
+        return a > b ? ifGreater : otherwise;
+    }
+
+    template <typename FloatType>
+    Register<FloatType> selectGreater(Register<FloatType> a, Register<FloatType> b, Register<FloatType> ifGreater, Register<FloatType> otherwise) {
+        auto mask = Register<FloatType>::greaterThan(a, b);
+        return (ifGreater & mask) | toBits(otherwise & ~mask);
+    }
+
+    //returns ifPositive where x > 0 and otherwise elsewhere
+    template <typename SampleType>
+    SampleType selectPositive(SampleType x, SampleType ifPositive, SampleType otherwise) {
+        return selectGreater(x, expand<SampleType>(0), ifPositive, otherwise);
+    }
+
+    //applies a scalar function to every lane, for what has no register version
+    template <typename Function>
+    float forEachLane(float x, Function&& function) {
+        return function(x);
+    }
+
+    template <typename Function>
+    double forEachLane(double x, Function&& function) {
+        return function(x);
+    }
+
+    template <typename FloatType, typename Function>
+    Register<FloatType> forEachLane(Register<FloatType> x, Function&& function) {
+        for (size_t i = 0; i < Register<FloatType>::size(); i++) {
+            x.set(i, function(x.get(i)));
+        }
+        return x;
+    }
+
+    //loads one field of the per-channel state structs of the listed channels into the lanes of a register, unused lanes are zeroed
+    template <typename FloatType, typename State>
+    Register<FloatType> loadLanes(const State* states, const int* channels, FloatType State::* field, int numChannels) {
+        alignas(Register<FloatType>::SIMDRegisterSize) FloatType lanes[Register<FloatType>::size()] = {};
+        for (int i = 0; i < numChannels; i++) {
+            lanes[i] = states[channels[i]].*field;
+        }
+        return Register<FloatType>::fromRawArray(lanes);
+    }
+
+    template <typename FloatType, typename State>
+    void storeLanes(Register<FloatType> x, State* states, const int* channels, FloatType State::* field, int numChannels) {
+        alignas(Register<FloatType>::SIMDRegisterSize) FloatType lanes[Register<FloatType>::size()];
+        x.copyToRawArray(lanes);
+        for (int i = 0; i < numChannels; i++) {
+            states[channels[i]].*field = lanes[i];
+        }
+    }
+
+    //the same for one element of an array field
+    template <typename FloatType, typename State, size_t size>
+    Register<FloatType> loadLanes(const State* states, const int* channels, FloatType (State::* field)[size], int index, int numChannels) {
+        alignas(Register<FloatType>::SIMDRegisterSize) FloatType lanes[Register<FloatType>::size()] = {};
+        for (int i = 0; i < numChannels; i++) {
+            lanes[i] = (states[channels[i]].*field)[index];
+        }
+        return Register<FloatType>::fromRawArray(lanes);
+    }
+
+    template <typename FloatType, typename State, size_t size>
+    void storeLanes(Register<FloatType> x, State* states, const int* channels, FloatType (State::* field)[size], int index, int numChannels) {
+        alignas(Register<FloatType>::SIMDRegisterSize) FloatType lanes[Register<FloatType>::size()];
+        x.copyToRawArray(lanes);
+        for (int i = 0; i < numChannels; i++) {
+            (states[channels[i]].*field)[index] = lanes[i];
+        }
+    }
+
+    //max across the lanes that hold a channel
+    template <typename FloatType>
+    FloatType maxOfLanes(Register<FloatType> x, int numChannels) {
+        FloatType result = x.get(0);
+        for (int i = 1; i < numChannels; i++) {
+            result = juce::jmax(result, x.get(i));
+        }
+        return result;
+    }
+
+    //packs every channel of the block into one register per sample
+    template <typename FloatType>
+    void interleave(const juce::dsp::AudioBlock<FloatType>& block, Register<FloatType>* dest) {
+        int numChannels = static_cast<int>(block.getNumChannels());
+        int numSamples = static_cast<int>(block.getNumSamples());
+        jassert(numChannels <= static_cast<int>(Register<FloatType>::size()));
+
+        alignas(Register<FloatType>::SIMDRegisterSize) FloatType lanes[Register<FloatType>::size()] = {};
+        for (int sample = 0; sample < numSamples; sample++) {
+            for (int channel = 0; channel < numChannels; channel++) {
+                lanes[channel] = block.getChannelPointer(channel)[sample];
+            }
+            dest[sample] = Register<FloatType>::fromRawArray(lanes);
+        }
+    }
+
+    template <typename FloatType>
+    void deinterleave(const Register<FloatType>* source, const juce::dsp::AudioBlock<FloatType>& block) {
+        int numChannels = static_cast<int>(block.getNumChannels());
+        int numSamples = static_cast<int>(block.getNumSamples());
+
+        alignas(Register<FloatType>::SIMDRegisterSize) FloatType lanes[Register<FloatType>::size()];
+        for (int sample = 0; sample < numSamples; sample++) {
+            source[sample].copyToRawArray(lanes);
+            for (int channel = 0; channel < numChannels; channel++) {
+                block.getChannelPointer(channel)[sample] = lanes[channel];
+            }
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    WaveShaper.h
+    Created: 18 Oct 2026 9:12:48pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FastMath.h"
+#include "SIMDHelpers.h"
+
+//the transfer curves, specialized at compile time on the curve and flags so each instantiation
+//has no per-sample branches left and inlines straight into the stage loop.
+namespace WaveShaper {
+    enum Curve {
+        sine = 1, //big
+        exponential, //thick
+        logarithmic, //fat
+        hyperbolicTangent //hot
+    };
+
+    //values that only change per block
+    struct Settings {
+        float softness;
+        float knee;
+        float sineClipThreshold; //where the sine curve reaches 1
+    };
+
+    inline Settings makeSettings(float softness, float knee) {
+        return { softness, knee, std::asin(1 - knee) + knee };
+    }
+
+    //input x, return function(x). SampleType is float or double, or a register of them. the knee, the clip
+    //and the sign are picked with selects rather than branches, so a register runs every lane at once
+    template <int curve, bool clipPeaks, FastMath::Accuracy accuracy, typename SampleType>
+    inline SampleType shape(SampleType sampleData, const Settings& settings) {
+        using FloatType = SIMDHelpers::ElementType<SampleType>;
+        using SIMDHelpers::expand;
+
+        SampleType knee = expand<SampleType>(settings.knee);
+        SampleType magnitude = SIMDHelpers::abs(sampleData);
+        SampleType overKnee = magnitude - knee;
+        SampleType curved;
+
+        if constexpr (curve == sine) {
+            curved = FastMath::sin(overKnee, accuracy) + knee;
+        }
+        else if constexpr (curve == exponential) { // -e^-x + 1
+            curved = FastMath::exp(overKnee * FloatType(-1), accuracy) * FloatType(-1) + knee + FloatType(1);
+        }
+        else if constexpr (curve == logarithmic) { // ln(x+1), the argument is kept positive for the unused side
+            curved = FastMath::log(SIMDHelpers::max(overKnee, expand<SampleType>(0)) + FloatType(1), accuracy) + knee;
+        }
+        else { //tanh(x)
+            curved = FastMath::tanh(overKnee, accuracy) + knee;
+        }
+        SampleType waveShapedData = SIMDHelpers::selectGreater(magnitude, knee, curved, magnitude);
+
+        if constexpr (curve == sine && clipPeaks) {
+            waveShapedData = SIMDHelpers::selectGreater(expand<SampleType>(settings.sineClipThreshold), magnitude, waveShapedData, expand<SampleType>(1));
+        }
+
+        if constexpr (clipPeaks) {
+            waveShapedData = SIMDHelpers::min(waveShapedData, expand<SampleType>(1));
+        }
+
+        FloatType softness = settings.softness;
+        waveShapedData = waveShapedData * softness + SIMDHelpers::min(magnitude, expand<SampleType>(1)) * (1 - softness);
+
+        return SIMDHelpers::selectPositive(sampleData, waveShapedData, waveShapedData * FloatType(-1));
+    }
+
+    //antiderivatives, for antiderivative antialiasing. these are worked out in double, the difference
+    //of two of them divided by a small step loses too much in float.
+
+    //how far over the knee the curve reaches 1, where clipPeaks flattens it
+    template <int curve>
+    inline double getClipPoint(double knee) {
+        if constexpr (curve == sine) {
+            return std::asin(1 - knee);
+        }
+        else if constexpr (curve == exponential) {
+            return knee > 0 ? -std::log(knee) : HUGE_VAL;
+        }
+        else if constexpr (curve == logarithmic) {
+            return std::exp(1 - knee) - 1;
+        }
+        else {
+            return knee > 0 ? std::atanh(1 - knee) : HUGE_VAL;
+        }
+    }
+
+    //integral of the curve from the knee to x over it, without the knee offset
+    template <int curve>
+    inline double curveIntegral(double x) {
+        if constexpr (curve == sine) {
+            return 1 - std::cos(x);
+        }
+        else if constexpr (curve == exponential) { // x + e^-x
+            return x + std::exp(-x) - 1;
+        }
+        else if constexpr (curve == logarithmic) { // (x+1)ln(x+1) - x
+            return (x + 1) * std::log1p(x) - x;
+        }
+        else { //ln(cosh(x)), written so it doesn't overflow
+            return x + std::log1p(std::exp(-2 * x)) - std::log(2.0);
+        }
+    }
+
+    //integral of shape() from 0 to x, with the knee, clipped peaks and softness. shape() is odd so this is even
+    template <int curve, bool clipPeaks>
+    inline double shapeIntegral(double sampleData, const Settings& settings) {
+        double knee = settings.knee;
+        double magnitude = std::abs(sampleData);
+        double shapedIntegral;
+
+        if (magnitude <= knee) {
+            shapedIntegral = magnitude * magnitude / 2;
+        }
+        else {
+            //straight up to the knee, then the curve shifted up by the knee, then flat at 1 past the clip point
+            double overKnee = magnitude - knee;
+            double curved = clipPeaks ? std::fmin(overKnee, getClipPoint<curve>(knee)) : overKnee;
+            shapedIntegral = knee * knee / 2 + knee * curved + curveIntegral<curve>(curved) + (overKnee - curved);
+        }
+
+        //the straight line blended in by softness, clipped at 1
+        double linearIntegral = magnitude <= 1 ? magnitude * magnitude / 2 : magnitude - 0.5;
+
+        double softness = settings.softness;
+        return softness * shapedIntegral + (1 - softness) * linearIntegral;
+    }
+}
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    WorkerPool.h
+    Created: 18 Oct 2026 9:26:43pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//a few worker threads for offline renders, where one block at a high oversampling factor is worth splitting up.
+//run() hands out tasks 0 to numTasks - 1, and the workers and the calling thread each claim the next unclaimed
+//task until none are left, so a slow task never holds the others up. nothing is allocated per run.
+class WorkerPool {
+public:
+    ~WorkerPool() {
+        stop();
+    }
+
+    //message thread, while the audio thread isn't running
+    void start(int numWorkers) {
+        if (numWorkers == static_cast<int>(workers.size())) {
+            return;
+        }
+        stop();
+
+        for (int i = 0; i < numWorkers; i++) {
+            workers.push_back(std::make_unique<Worker>(*this));
+            workers.back()->startThread();
+        }
+    }
+
+    void stop() {
+        for (auto& worker : workers) {
+            worker->signalThreadShouldExit();
+            worker->notify();
+        }
+        for (auto& worker : workers) {
+            worker->stopThread(1000);
+        }
+        workers.clear();
+    }
+
+    int getNumWorkers() const {
+        return static_cast<int>(workers.size());
+    }
+
+    //calls task(index) for every index from 0 to numTasks - 1 and returns once they have all finished.
+    //tasks run in any order on any thread, so each one must only touch its own data.
+    template <typename Function>
+    void run(int numTasks, Function& task) {
+        jassert(numTasks < 0x10000);
+
+        if (numTasks <= 0) {
+            return;
+        }
+
+        context = &task;
+        invoke = [](void* function, int index) { (*static_cast<Function*>(function))(index); };
+        numFinished.store(0);
+
+        //the generation keeps a worker that wakes up late from claiming tasks of a run that has already finished
+        generation = (generation + 1) & 0xffff;
+        nextTask.store((static_cast<juce::uint64>(generation) << 48) | (static_cast<juce::uint64>(numTasks) << 32));
+
+        for (auto& worker : workers) {
+            worker->notify();
+        }
+
+        work();
+
+        //whichever thread finishes the last task signals, which may already have been this one
+        finished.wait(-1);
+    }
+
+private:
+    struct Worker : public juce::Thread {
+        explicit Worker(WorkerPool& owner) : juce::Thread("THICC worker"), pool(owner) {}
+
+        void run() override {
+            while (!threadShouldExit()) {
+                wait(-1);
+                pool.work();
+            }
+        }
+
+        WorkerPool& pool;
+    };
+
+    //claims and runs tasks until every task of the current run has been claimed
+    void work() {
+        juce::uint64 current = nextTask.load();
+
+        while (true) {
+            int index = static_cast<int>(current & 0xffffffff);
+            int numTasks = static_cast<int>((current >> 32) & 0xffff);
+
+            if (index >= numTasks) {
+                return;
+            }
+
+            //on failure current is reloaded, and may belong to a newer run by then
+            if (nextTask.compare_exchange_weak(current, current + 1)) {
+                invoke(context, index);
+
+                if (numFinished.fetch_add(1) + 1 == numTasks) {
+                    finished.signal();
+                }
+                current = nextTask.load();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    //generation in the top 16 bits, the number of tasks in the next 16 and the next unclaimed task in the low 32
+    std::atomic<juce::uint64> nextTask { 0 };
+    std::atomic<int> numFinished { 0 };
+    juce::WaitableEvent finished; //resets itself when run() wakes up
+    int generation = 0;
+
+    void* context = nullptr;
+    void (*invoke)(void*, int) = nullptr;
+};
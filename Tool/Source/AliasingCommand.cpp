@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    AliasingCommand.cpp
+    Created: 20 Oct 2026 2:17:36pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+
+#define FFT_ORDER 14
+
+struct AliasingResult {
+    double aliasing; //dB, everything that isn't a harmonic of the tone against the harmonics
+    double realtime; //times faster than real time
+};
+
+//drives a sine that fits the fft window exactly, so the tone, its harmonics and everything folded back from above
+//nyquist land on whole bins. the harmonics are the bins at multiples of the tone's bin, every other bin is aliasing.
+static AliasingResult measureAliasing(const juce::MemoryBlock& state, int factor, bool isAntialiased, int toneBin, int sampleRate, int blockSize) {
+    const int fftSize = 1 << FFT_ORDER;
+
+    THICCAudioProcessor processor;
+    if (!ToolCommands::setChannelCount(processor, 1)) {
+        juce::ConsoleApplication::fail("Mono isn't supported");
+    }
+
+    processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    ToolCommands::setParameter(processor, "OSFactor", static_cast<float>(factor));
+    ToolCommands::setParameter(processor, "antialiasing", isAntialiased ? 1.0f : 0.0f);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    //a second for the smoothers and dc blockers to settle, then the window
+    int numBlocks = (sampleRate + fftSize + blockSize - 1) / blockSize;
+    std::vector<float> output(static_cast<size_t>(numBlocks * blockSize));
+
+    juce::AudioBuffer<float> buffer(1, blockSize);
+    juce::MidiBuffer midi;
+    juce::int64 elapsed = 0;
+
+    for (int block = 0; block < numBlocks; block++) {
+        float* channelData = buffer.getWritePointer(0);
+        for (int sample = 0; sample < blockSize; sample++) {
+            //the phase is wrapped in whole samples so it stays exact however long this runs
+            juce::int64 position = ((static_cast<juce::int64>(block) * blockSize + sample) * toneBin) & (fftSize - 1);
+            channelData[sample] = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * position / fftSize));
+        }
+
+        juce::int64 start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midi);
+        elapsed += juce::Time::getHighResolutionTicks() - start;
+
+        std::copy(channelData, channelData + blockSize, output.begin() + block * blockSize);
+    }
+
+    processor.releaseResources();
+
+    juce::dsp::FFT fft(FFT_ORDER);
+    std::vector<float> spectrum(static_cast<size_t>(fftSize * 2));
+    std::copy(output.end() - fftSize, output.end(), spectrum.begin());
+    fft.performFrequencyOnlyForwardTransform(spectrum.data());
+
+    double harmonicPower = 0;
+    double aliasingPower = 0;
+    for (int bin = 1; bin <= fftSize / 2; bin++) { //dc is left out, the dc blockers are still getting rid of it
+        double power = static_cast<double>(spectrum[bin]) * spectrum[bin];
+        if (bin % toneBin == 0) {
+            harmonicPower += power;
+        }
+        else {
+            aliasingPower += power;
+        }
+    }
+
+    AliasingResult result;
+    result.aliasing = 10 * std::log10(juce::jmax(aliasingPower, 1.0e-30) / juce::jmax(harmonicPower, 1.0e-30));
+    result.realtime = (static_cast<double>(numBlocks) * blockSize / sampleRate) / juce::Time::highResolutionTicksToSeconds(elapsed);
+    return result;
+}
+
+//compares oversampling with and without antiderivative antialiasing, how much aliasing each one leaves and what it costs.
+//the settings are the defaults with 12 dB of drive, or a saved state, with --set values applied on top.
+void ToolCommands::aliasing(const juce::ArgumentList& args) {
+    int sampleRate = juce::jmax(8000, getIntOption(args, "--rate", 48000));
+    int blockSize = juce::jmax(16, getIntOption(args, "--block", 512));
+    double frequency = args.containsOption("--frequency") ? args.getValueForOption("--frequency").getDoubleValue() : 5000.0;
+
+    //an odd bin shares no factor with the window length, so no harmonic folds back onto another harmonic
+    const int fftSize = 1 << FFT_ORDER;
+    int toneBin = juce::jlimit(1, fftSize / 2 - 1, juce::roundToInt(frequency * fftSize / sampleRate)) | 1;
+
+    THICCAudioProcessor settings;
+    setParameter(settings, "drive", 12.0f);
+
+    if (args.containsOption("--state")) {
+        juce::MemoryBlock savedState;
+        if (!args.getExistingFileForOption("--state").loadFileAsData(savedState)) {
+            juce::ConsoleApplication::fail("Can't read the state file");
+        }
+        settings.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    }
+    applySetOption(settings, args);
+
+    juce::MemoryBlock state;
+    settings.getStateInformation(state);
+
+    std::cout << "tone: " << juce::String(static_cast<double>(toneBin) * sampleRate / fftSize, 1) << " Hz at " << sampleRate << " Hz" << std::endl << std::endl;
+    std::cout << "oversampling  antialiasing  aliasing     speed" << std::endl;
+
+    for (int factor = 1; factor <= 5; factor++) {
+        for (int isAntialiased = 0; isAntialiased < 2; isAntialiased++) {
+            AliasingResult result = measureAliasing(state, factor, isAntialiased == 1, toneBin, sampleRate, blockSize);
+
+            std::cout << (juce::String(1 << (factor - 1)) + "x").paddedRight(' ', 14)
+                      << juce::String(isAntialiased ? "on" : "off").paddedRight(' ', 14)
+                      << (juce::String(result.aliasing, 1) + " dB").paddedRight(' ', 13)
+                      << juce::String(result.realtime, 1) << "x realtime" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    BenchmarkCommand.cpp
+    Created: 19 Oct 2026 1:14:27am
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+
+//runs the same settings through the float and double paths at every oversampling factor
+void ToolCommands::benchmark(const juce::ArgumentList& args) {
+    double seconds = juce::jmax(1, getIntOption(args, "--seconds", 10));
+    int numChannels = juce::jmax(1, getIntOption(args, "--channels", 2));
+    int sampleRate = juce::jmax(8000, getIntOption(args, "--rate", 48000));
+    int blockSize = juce::jmax(16, getIntOption(args, "--block", 512));
+
+    int numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+    double renderedSeconds = static_cast<double>(numBlocks) * blockSize / sampleRate;
+    bool isStaged = args.containsOption("--stages");
+
+    //the float path's load meter readings, one row per factor
+    std::vector<LoadMeter::Stats> stageStats;
+
+    std::cout << "channels: " << numChannels << ", sample rate: " << sampleRate << ", block size: " << blockSize << std::endl;
+    std::cout << std::endl << "factor  float x realtime   double x realtime" << std::endl;
+
+    for (int factor = 1; factor <= 5; factor++) {
+        double speed[2];
+
+        for (int isDouble = 0; isDouble < 2; isDouble++) {
+            THICCAudioProcessor processor;
+
+            if (!setChannelCount(processor, numChannels)) {
+                juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+            }
+
+            setParameter(processor, "OSFactor", static_cast<float>(factor));
+            setParameter(processor, "drive", 12.0f);
+
+            processor.setProcessingPrecision(isDouble ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            double elapsed = isDouble ? renderNoise<double>(processor, numChannels, blockSize, numBlocks)
+                : renderNoise<float>(processor, numChannels, blockSize, numBlocks);
+            speed[isDouble] = renderedSeconds / elapsed;
+
+            if (!isDouble) {
+                stageStats.push_back(processor.getLoadMeter().getStats());
+            }
+
+            processor.releaseResources();
+        }
+
+        std::cout << juce::String(1 << (factor - 1)).paddedRight(' ', 8)
+                  << juce::String(speed[0], 1).paddedRight(' ', 19)
+                  << juce::String(speed[1], 1) << std::endl;
+    }
+
+    if (!isStaged) {
+        return;
+    }
+
+    if (!LoadMeter::isEnabled) {
+        juce::ConsoleApplication::fail("--stages needs a build with THICC_LOAD_METER=1, such as the Debug or Test configuration");
+    }
+
+    //percent of the real-time budget, so each row adds up to a little under 100 / (x realtime)
+    std::cout << std::endl << "factor  ";
+    for (int stage = 0; stage < LoadMeter::numStages; stage++) {
+        std::cout << juce::String(LoadMeter::getStageName(static_cast<LoadMeter::Stage>(stage))).paddedRight(' ', 12);
+    }
+    std::cout << "p99 block" << std::endl;
+
+    for (int factor = 1; factor <= 5; factor++) {
+        const LoadMeter::Stats& stats = stageStats[factor - 1];
+        std::cout << juce::String(1 << (factor - 1)).paddedRight(' ', 8);
+
+        for (int stage = 0; stage < LoadMeter::numStages; stage++) {
+            std::cout << (juce::String(stats.stageLoads[stage] * 100.0, 3) + "%").paddedRight(' ', 12);
+        }
+        std::cout << juce::String(stats.p99Load * 100.0, 3) << "%" << std::endl;
+    }
+}
@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    HeapCounter.cpp
+    Created: 18 Oct 2026 11:02:19pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "HeapCounter.h"
+#include "RealtimeChecker.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+//replacing the malloc family is only for builds with the realtime checks, a release build keeps the real one
+#define THICC_COUNT_MALLOC (THICC_REALTIME_CHECKS && JUCE_LINUX)
+
+#if THICC_COUNT_MALLOC
+ #include <cerrno>
+ #include <malloc.h>
+#endif
+
+static std::atomic<int64_t> liveBytes { 0 };
+static std::atomic<int64_t> allocationCount { 0 };
+
+int64_t HeapCounter::getLiveBytes() {
+    return liveBytes.load();
+}
+
+int64_t HeapCounter::getAllocationCount() {
+    return allocationCount.load();
+}
+
+bool HeapCounter::isCountingMalloc() {
+    return THICC_COUNT_MALLOC;
+}
+
+#if THICC_COUNT_MALLOC
+//the malloc family is replaced, which also counts what juce's buffers and HeapBlocks allocate with std::malloc,
+//and operator new goes through it. blocks are measured with malloc_usable_size, what the allocator handed out.
+//the real allocator is reached through glibc's own entry points.
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+}
+
+static void* counted(void* pointer) {
+    if (pointer != nullptr) {
+        liveBytes += static_cast<int64_t>(malloc_usable_size(pointer));
+        allocationCount++;
+    }
+    return pointer;
+}
+
+extern "C" {
+    void* malloc(size_t size) noexcept {
+        RealtimeChecker::ScopedCall call("malloc");
+        return counted(__libc_malloc(size));
+    }
+
+    void* calloc(size_t count, size_t size) noexcept {
+        RealtimeChecker::ScopedCall call("calloc");
+        return counted(__libc_calloc(count, size));
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept {
+        RealtimeChecker::ScopedCall call("realloc");
+        int64_t oldSize = pointer != nullptr ? static_cast<int64_t>(malloc_usable_size(pointer)) : 0;
+        void* result = __libc_realloc(pointer, size);
+
+        //a null result with a size left the old block where it was, with none it freed it
+        if (result != nullptr) {
+            liveBytes += static_cast<int64_t>(malloc_usable_size(result)) - oldSize;
+            allocationCount += pointer == nullptr ? 1 : 0;
+        }
+        else if (size == 0) {
+            liveBytes -= oldSize;
+        }
+        return result;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept {
+        RealtimeChecker::ScopedCall call("aligned_alloc");
+        return counted(__libc_memalign(alignment, size));
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept {
+        RealtimeChecker::ScopedCall call("posix_memalign");
+        *pointer = counted(__libc_memalign(alignment, size));
+        return *pointer == nullptr && size > 0 ? ENOMEM : 0;
+    }
+
+    void free(void* pointer) noexcept {
+        RealtimeChecker::ScopedCall call("free");
+        if (pointer != nullptr) {
+            liveBytes -= static_cast<int64_t>(malloc_usable_size(pointer));
+            __libc_free(pointer);
+        }
+    }
+}
+
+static void* countedAllocate(size_t size, size_t alignment) {
+    RealtimeChecker::ScopedCall call("operator new");
+    void* pointer = nullptr;
+
+    if (alignment <= alignof(std::max_align_t)) {
+        pointer = std::malloc(size);
+    }
+    else if (posix_memalign(&pointer, alignment, size) != 0) {
+        pointer = nullptr;
+    }
+
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+static void countedFree(void* pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+
+    RealtimeChecker::ScopedCall call("operator delete");
+    std::free(pointer);
+}
+#else
+//only operator new can be replaced portably, so otherwise what juce allocates with std::malloc isn't counted.
+//each block is preceded by a header holding the size and the pointer malloc returned
+struct BlockHeader {
+    void* rawPointer;
+    size_t size;
+};
+
+static void* countedAllocate(size_t size, size_t alignment) {
+    RealtimeChecker::ScopedCall call("operator new");
+
+    if (alignment < alignof(std::max_align_t)) {
+        alignment = alignof(std::max_align_t);
+    }
+
+    char* raw = static_cast<char*>(std::malloc(size + sizeof(BlockHeader) + alignment));
+    if (raw == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(raw + sizeof(BlockHeader));
+    address = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+    auto* header = reinterpret_cast<BlockHeader*>(address) - 1;
+    header->rawPointer = raw;
+    header->size = size;
+
+    liveBytes += static_cast<int64_t>(size);
+    allocationCount++;
+
+    return reinterpret_cast<void*>(address);
+}
+
+static void countedFree(void* pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+
+    RealtimeChecker::ScopedCall call("operator delete");
+    auto* header = static_cast<BlockHeader*>(pointer) - 1;
+    liveBytes -= static_cast<int64_t>(header->size);
+    std::free(header->rawPointer);
+}
+#endif
+
+void* operator new(size_t size) { return countedAllocate(size, 0); }
+void* operator new[](size_t size) { return countedAllocate(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAllocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { countedFree(pointer); }
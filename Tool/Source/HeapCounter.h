@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    HeapCounter.h
+    Created: 18 Oct 2026 11:02:19pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+
+//counts every allocation made in the tool, the replacements are in HeapCounter.cpp. in a build with the realtime
+//checks on linux that is the malloc family, which operator new and juce's buffers both go through, otherwise only
+//operator new.
+namespace HeapCounter {
+    //bytes currently allocated
+    int64_t getLiveBytes();
+
+    //allocations made since the program started
+    int64_t getAllocationCount();
+
+    //false when only operator new is counted
+    bool isCountingMalloc();
+}
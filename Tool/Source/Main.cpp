@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026 11:04:12pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ToolCommands.h"
+
+//command line tool that runs the plugin's processor outside of a host
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage:", true);
+
+    app.addCommand({ "measure",
+                     "measure [--instances=N] [--channels=N] [--rate=R] [--block=B]",
+                     "Reports construction time and heap footprint per instance.",
+                     "Builds N processors, then prepares them at every oversampling factor, IIR and linear phase, "
+                     "and prints the time and heap bytes one instance costs at each step.",
+                     [](const juce::ArgumentList& args) { ToolCommands::measure(args); } });
+
+    app.addCommand({ "benchmark",
+                     "benchmark [--seconds=S] [--channels=N] [--rate=R] [--block=B] [--stages]",
+                     "Compares the float and double processing paths.",
+                     "Renders S seconds of noise through both paths at every oversampling factor "
+                     "and prints how many times faster than real time each one runs. "
+                     "--stages also prints the share of the real-time budget each stage of the float path took.",
+                     [](const juce::ArgumentList& args) { ToolCommands::benchmark(args); } });
+
+    app.addCommand({ "render",
+                     "render <files or folders...> --out=FOLDER [--state=FILE] [--set=id=value,...] [--save-state=FILE] [--threads=N] [--block=B]",
+                     "Processes WAV, FLAC and AIFF files offline.",
+                     "Loads the settings from a state saved by the plugin, applies any --set values on top, and renders every file "
+                     "into the output folder with the same name and format. Files are spread over N worker threads, all cores by default. "
+                     "--save-state writes the combined settings out for later runs.",
+                     [](const juce::ArgumentList& args) { ToolCommands::render(args); } });
+
+    app.addCommand({ "suite",
+                     "suite [--seconds=S] [--channels=N] [--rate=R] [--out=FILE]",
+                     "Times the processing kernels and writes the results as JSON.",
+                     "Renders S seconds of noise (0.5 by default) through processBlock for every curve, clip and saturation mode, "
+                     "even and odd harmonics, filter setting, oversampling factor and block size from 32 to 4096, then times the "
+                     "curves and the oversampler on their own. Every result is in ns per sample of one channel.",
+                     [](const juce::ArgumentList& args) { ToolCommands::suite(args); } });
+
+    app.addCommand({ "aliasing",
+                     "aliasing [--frequency=F] [--state=FILE] [--set=id=value,...] [--rate=R] [--block=B]",
+                     "Measures aliasing and speed with and without antiderivative antialiasing.",
+                     "Drives a sine near F Hz (5000 by default) through the plugin at every oversampling factor, with antialiasing off "
+                     "and on, and prints the power of everything that isn't a harmonic of the tone relative to the harmonics, and how "
+                     "many times faster than real time each setting runs. The settings are the defaults with 12 dB of drive, or a saved state, "
+                     "with any --set values applied on top.",
+                     [](const juce::ArgumentList& args) { ToolCommands::aliasing(args); } });
+
+    app.addCommand({ "verify",
+                     "verify [--write=FOLDER | --against=FOLDER] [--tolerance=DB]",
+                     "Checks that the output hasn't changed, and that the fast paths match their references.",
+                     "Renders a sweep and noise through every combination of curve, clip or saturation, even or odd, clipped peaks, "
+                     "filters, oversampling factor and antialiasing. --write stores the renders as references, --against compares "
+                     "against stored ones and fails on any sample further apart than the tolerance (-100 dBFS by default). "
+                     "Every run also null tests SIMD channel groups against the single channel path, eco curves against precise "
+                     "ones, and the specialized curve kernels against the original curves.",
+                     [](const juce::ArgumentList& args) { ToolCommands::verify(args); } });
+
+    app.addCommand({ "realtime",
+                     "realtime [--seconds=S] [--channels=N] [--rate=R] [--block=B]",
+                     "Checks that processBlock never allocates, locks or blocks.",
+                     "Runs the plugin on an audio thread for S seconds at each precision (5 by default), with blocks from 1 sample to "
+                     "more than it was prepared for and input from loud to silent, while the message thread keeps changing parameters, "
+                     "oversampling, presets and metering. Fails with the stack of every allocation, free, mutex lock, wait, sleep or "
+                     "file read or write made inside processBlock. Needs a build with THICC_REALTIME_CHECKS=1, and only catches "
+                     "operator new and delete on platforms other than Linux.",
+                     [](const juce::ArgumentList& args) { ToolCommands::realtime(args); } });
+
+    return app.findAndRunCommand(argc, argv);
+}
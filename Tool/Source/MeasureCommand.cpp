@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    MeasureCommand.cpp
+    Created: 18 Oct 2026 11:08:51pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+#include "HeapCounter.h"
+
+static double ticksToMilliseconds(juce::int64 ticks) {
+    return 1000.0 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+}
+
+static juce::String formatKilobytes(double bytes) {
+    return juce::String(bytes / 1024.0, 1) + " KB";
+}
+
+//the oversampler on its own, built the way the chains build it, one for the whole bus. the filters are designed when
+//it is constructed, and those tables are all that instances could share. initProcessing then adds the stage buffers.
+static void measureOversampler(int numChannels, int factor, bool linearPhase, int blockSize, double& filterBytes, double& bufferBytes) {
+    auto filterType = linearPhase ? juce::dsp::Oversampling<float>::FilterType::filterHalfBandFIREquiripple
+        : juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR;
+
+    juce::int64 bytesBefore = HeapCounter::getLiveBytes();
+    juce::dsp::Oversampling<float> oversampler(static_cast<size_t>(numChannels), static_cast<size_t>(factor), filterType, true, true);
+    juce::int64 bytesBuilt = HeapCounter::getLiveBytes();
+    oversampler.initProcessing(static_cast<size_t>(blockSize));
+
+    filterBytes = static_cast<double>(bytesBuilt - bytesBefore);
+    bufferBytes = static_cast<double>(HeapCounter::getLiveBytes() - bytesBuilt);
+}
+
+//builds a batch of instances and reports what one instance costs, first right after
+//construction and then after prepareToPlay for every oversampling setting.
+void ToolCommands::measure(const juce::ArgumentList& args) {
+    int numInstances = juce::jmax(1, getIntOption(args, "--instances", 16));
+    int sampleRate = juce::jmax(8000, getIntOption(args, "--rate", 48000));
+    int blockSize = juce::jmax(16, getIntOption(args, "--block", 512));
+    int numChannels = juce::jmax(1, getIntOption(args, "--channels", 2));
+
+    std::cout << "instances: " << numInstances << ", channels: " << numChannels << ", sample rate: " << sampleRate
+              << ", block size: " << blockSize << std::endl;
+    if (!HeapCounter::isCountingMalloc()) {
+        std::cout << "only operator new is counted in this build, juce's buffers are missing from the heap figures" << std::endl;
+    }
+
+    std::vector<std::unique_ptr<THICCAudioProcessor>> instances;
+    instances.reserve(static_cast<size_t>(numInstances));
+
+    juce::int64 bytesBefore = HeapCounter::getLiveBytes();
+    juce::int64 allocationsBefore = HeapCounter::getAllocationCount();
+    juce::int64 start = juce::Time::getHighResolutionTicks();
+
+    for (int i = 0; i < numInstances; i++) {
+        instances.push_back(std::make_unique<THICCAudioProcessor>());
+
+        if (!setChannelCount(*instances.back(), numChannels)) {
+            juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+        }
+    }
+
+    juce::int64 elapsed = juce::Time::getHighResolutionTicks() - start;
+    double constructedBytes = static_cast<double>(HeapCounter::getLiveBytes() - bytesBefore) / numInstances;
+
+    std::cout << "construction: " << ticksToMilliseconds(elapsed) / numInstances << " ms, "
+              << formatKilobytes(constructedBytes) << ", "
+              << (HeapCounter::getAllocationCount() - allocationsBefore) / numInstances << " allocations per instance" << std::endl;
+
+    //the last two columns are the instance's oversampler, which covers every channel
+    std::cout << std::endl << "factor  phase    prepare ms   heap per instance   os filters   os buffers" << std::endl;
+
+    for (int linearPhase = 0; linearPhase < 2; linearPhase++) {
+        for (int factor = 1; factor <= 5; factor++) {
+            for (auto& instance : instances) {
+                setParameter(*instance, "OSFactor", static_cast<float>(factor));
+                setParameter(*instance, "linearPhase", static_cast<float>(linearPhase));
+            }
+
+            start = juce::Time::getHighResolutionTicks();
+
+            for (auto& instance : instances) {
+                instance->prepareToPlay(sampleRate, blockSize);
+            }
+
+            elapsed = juce::Time::getHighResolutionTicks() - start;
+            //preparing again replaces the previous chain, so this is only the current factor's footprint
+            double preparedBytes = static_cast<double>(HeapCounter::getLiveBytes() - bytesBefore) / numInstances;
+
+            double filterBytes, bufferBytes;
+            measureOversampler(numChannels, factor - 1, linearPhase != 0, blockSize, filterBytes, bufferBytes);
+
+            std::cout << juce::String(1 << (factor - 1)).paddedRight(' ', 8)
+                      << juce::String(linearPhase ? "linear" : "iir").paddedRight(' ', 9)
+                      << juce::String(ticksToMilliseconds(elapsed) / numInstances, 3).paddedRight(' ', 13)
+                      << formatKilobytes(preparedBytes).paddedRight(' ', 20)
+                      << formatKilobytes(filterBytes).paddedRight(' ', 13)
+                      << formatKilobytes(bufferBytes) << std::endl;
+        }
+    }
+}
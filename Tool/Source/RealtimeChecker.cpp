@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    RealtimeChecker.cpp
+    Created: 21 Oct 2026 4:12:51pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "RealtimeChecker.h"
+
+#if THICC_REALTIME_CHECKS && JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+//the debug crt lets a hook see every heap call, the release one used by the Test configuration doesn't
+#if THICC_REALTIME_CHECKS && JUCE_WINDOWS && defined(_DEBUG)
+ #define THICC_CRT_HOOK 1
+#else
+ #define THICC_CRT_HOOK 0
+#endif
+
+#if THICC_CRT_HOOK
+ #include <crtdbg.h>
+#endif
+
+#define MAX_REPORTS 32 //distinct stacks kept, later ones are only counted
+
+//plain values, so nothing has to be constructed on first use from inside a replaced malloc
+static thread_local int callbackDepth = 0;
+static thread_local bool isInsideCall = false;
+
+static std::atomic<int> numViolations { 0 };
+static std::mutex reportLock;
+static std::vector<RealtimeChecker::Report> reports;
+
+const char* RealtimeChecker::getUncaughtCalls() {
+   #if THICC_REALTIME_CHECKS && JUCE_LINUX
+    return nullptr;
+   #elif THICC_CRT_HOOK
+    return "locks, waits, sleeps and file access";
+   #else
+    return "malloc and free, locks, waits, sleeps and file access";
+   #endif
+}
+
+RealtimeChecker::AudioCallback::AudioCallback() {
+    callbackDepth++;
+}
+
+RealtimeChecker::AudioCallback::~AudioCallback() {
+    callbackDepth--;
+}
+
+RealtimeChecker::ScopedCall::ScopedCall(const char* name) : isOutermost(!isInsideCall) {
+    if (!isEnabled || !isOutermost) {
+        return;
+    }
+
+    //set before reporting, the report allocates and locks too
+    isInsideCall = true;
+
+    if (callbackDepth > 0) {
+        numViolations++;
+
+        juce::String stackTrace = juce::SystemStats::getStackBacktrace();
+        std::lock_guard<std::mutex> lock(reportLock);
+
+        for (auto& report : reports) {
+            if (report.call == name && report.stackTrace == stackTrace) {
+                report.count++;
+                return;
+            }
+        }
+        if (reports.size() < MAX_REPORTS) {
+            reports.push_back({ name, stackTrace, 1 });
+        }
+    }
+}
+
+RealtimeChecker::ScopedCall::~ScopedCall() {
+    if (isOutermost) {
+        isInsideCall = false;
+    }
+}
+
+int RealtimeChecker::getNumViolations() {
+    return numViolations.load();
+}
+
+std::vector<RealtimeChecker::Report> RealtimeChecker::getReports() {
+    std::lock_guard<std::mutex> lock(reportLock);
+    return reports;
+}
+
+void RealtimeChecker::clear() {
+    std::lock_guard<std::mutex> lock(reportLock);
+    reports.clear();
+    numViolations.store(0);
+}
+
+#if THICC_CRT_HOOK
+//the crt's own blocks are left alone, reporting allocates and that would come straight back here
+static int crtAllocationHook(int type, void*, size_t, int blockType, long, const unsigned char*, int) {
+    if (blockType != _CRT_BLOCK) {
+        RealtimeChecker::ScopedCall call(type == _HOOK_ALLOC ? "malloc" : type == _HOOK_REALLOC ? "realloc" : "free");
+    }
+    return 1;
+}
+
+static const bool isCrtHookInstalled = (_CrtSetAllocHook(crtAllocationHook), true);
+#endif
+
+#if THICC_REALTIME_CHECKS && JUCE_LINUX
+//the replacements check, then pass the call on to the next definition after this program's, looked up the first
+//time it is called. the malloc family is replaced in HeapCounter.cpp, which counts it too
+
+template <typename Function>
+static Function findNext(Function& next, const char* name) {
+    if (next == nullptr) {
+        next = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+    }
+    return next;
+}
+
+#define PASS_ON(name, ...) \
+    static decltype(&::name) next_##name = nullptr; \
+    return findNext(next_##name, #name)(__VA_ARGS__)
+
+extern "C" {
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+        RealtimeChecker::ScopedCall call("pthread_mutex_lock");
+        PASS_ON(pthread_mutex_lock, mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept {
+        RealtimeChecker::ScopedCall call("pthread_rwlock_rdlock");
+        PASS_ON(pthread_rwlock_rdlock, lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept {
+        RealtimeChecker::ScopedCall call("pthread_rwlock_wrlock");
+        PASS_ON(pthread_rwlock_wrlock, lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) {
+        RealtimeChecker::ScopedCall call("pthread_cond_wait");
+        PASS_ON(pthread_cond_wait, condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time) {
+        RealtimeChecker::ScopedCall call("pthread_cond_timedwait");
+        PASS_ON(pthread_cond_timedwait, condition, mutex, time);
+    }
+
+    int pthread_join(pthread_t thread, void** result) {
+        RealtimeChecker::ScopedCall call("pthread_join");
+        PASS_ON(pthread_join, thread, result);
+    }
+
+    int sem_wait(sem_t* semaphore) {
+        RealtimeChecker::ScopedCall call("sem_wait");
+        PASS_ON(sem_wait, semaphore);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+        RealtimeChecker::ScopedCall call("nanosleep");
+        PASS_ON(nanosleep, duration, remaining);
+    }
+
+    int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining) {
+        RealtimeChecker::ScopedCall call("clock_nanosleep");
+        PASS_ON(clock_nanosleep, clock, flags, duration, remaining);
+    }
+
+    int usleep(useconds_t duration) {
+        RealtimeChecker::ScopedCall call("usleep");
+        PASS_ON(usleep, duration);
+    }
+
+    ssize_t read(int file, void* data, size_t size) {
+        RealtimeChecker::ScopedCall call("read");
+        PASS_ON(read, file, data, size);
+    }
+
+    ssize_t write(int file, const void* data, size_t size) {
+        RealtimeChecker::ScopedCall call("write");
+        PASS_ON(write, file, data, size);
+    }
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    RealtimeChecker.h
+    Created: 21 Oct 2026 4:12:51pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//on in debug builds, anything else can turn it on with THICC_REALTIME_CHECKS=1 in its preprocessor definitions
+#ifndef THICC_REALTIME_CHECKS
+ #if JUCE_DEBUG
+  #define THICC_REALTIME_CHECKS 1
+ #else
+  #define THICC_REALTIME_CHECKS 0
+ #endif
+#endif
+
+//catches calls the audio thread must never make. a thread is checked while it is inside an AudioCallback, and
+//every allocation or free, mutex lock, wait, sleep and file read or write it makes there is a violation, kept
+//with the stack it was made from. operator new and delete are caught everywhere and the malloc family on linux,
+//through HeapCounter.cpp. the pthread calls and the rest are replaced in RealtimeChecker.cpp, also only on linux.
+//on windows a debug build hooks the crt heap, locks and the rest aren't caught.
+namespace RealtimeChecker {
+    constexpr bool isEnabled = THICC_REALTIME_CHECKS != 0;
+
+    //what this build can't catch on this platform, or nullptr when it catches everything
+    const char* getUncaughtCalls();
+
+    //marks the calling thread as the audio callback from construction to destruction
+    class AudioCallback {
+    public:
+        AudioCallback();
+        ~AudioCallback();
+    };
+
+    //wraps a call that the audio callback must not make, name is a string literal. anything the call does in
+    //turn isn't reported again, so an operator new is one violation and not one for it and one for its malloc.
+    class ScopedCall {
+    public:
+        explicit ScopedCall(const char* name);
+        ~ScopedCall();
+
+    private:
+        bool isOutermost;
+    };
+
+    //every violation from the same call and stack is one report
+    struct Report {
+        const char* call;
+        juce::String stackTrace;
+        int count;
+    };
+
+    //any thread, violations since the last clear
+    int getNumViolations();
+
+    //while no audio callback is running
+    std::vector<Report> getReports();
+    void clear();
+}
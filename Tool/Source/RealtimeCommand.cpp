@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    RealtimeCommand.cpp
+    Created: 21 Oct 2026 4:40:18pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+#include "RealtimeChecker.h"
+
+#define MESSAGE_INTERVAL 20 //ms the message thread runs between changes, so the processor's timer gets to run
+
+//plays the part of the host's audio thread. blocks come in every size from 1 sample to more than the processor
+//was prepared for, and the input goes from loud to quiet to silent, so the chain, the fast path and the gates
+//all get a turn. only processBlock is checked.
+template <typename FloatType>
+class AudioThread : public juce::Thread {
+public:
+    AudioThread(THICCAudioProcessor& processorToRun, int numChannelsToRun, int blockSize)
+        : juce::Thread("THICC audio"), processor(processorToRun), numChannels(numChannelsToRun), maxBlockSize(blockSize),
+          buffer(numChannelsToRun, blockSize * 3) {}
+
+    void run() override {
+        juce::MidiBuffer midi;
+        juce::Random random(1234);
+        const int blockSizes[] = { maxBlockSize, maxBlockSize / 3 + 1, 1, maxBlockSize * 5 / 2 };
+        const float levels[] = { 0.5f, 0.001f, 0.0f };
+
+        for (int block = 0; !threadShouldExit(); block++) {
+            int numSamples = blockSizes[block % 4];
+            float level = levels[(block / 64) % 3];
+
+            for (int channel = 0; channel < numChannels; channel++) {
+                FloatType* channelData = buffer.getWritePointer(channel);
+                for (int sample = 0; sample < numSamples; sample++) {
+                    channelData[sample] = static_cast<FloatType>((random.nextFloat() - 0.5f) * 2.0f * level);
+                }
+            }
+
+            juce::AudioBuffer<FloatType> hostBlock(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            {
+                RealtimeChecker::AudioCallback callback;
+                processor.processBlock(hostBlock, midi);
+            }
+
+            numBlocks++;
+            wait(1);
+        }
+    }
+
+    std::atomic<int> numBlocks { 0 };
+
+private:
+    THICCAudioProcessor& processor;
+    int numChannels;
+    int maxBlockSize;
+    juce::AudioBuffer<FloatType> buffer;
+};
+
+//one of the things a host or the editor does on the message thread while the audio is running
+static void changeSomething(THICCAudioProcessor& processor, juce::Random& random) {
+    auto& parameters = processor.getParameters();
+
+    switch (random.nextInt(6)) {
+        case 0:
+        case 1: {
+            //any parameter, which covers the curves, modes, filters and switching the oversampling
+            auto* parameter = parameters[random.nextInt(parameters.size())];
+            parameter->setValueNotifyingHost(random.nextFloat());
+            break;
+        }
+        case 2:
+            //dry, the fast path takes over
+            ToolCommands::setParameter(processor, "mix", random.nextBool() ? 0.0f : 100.0f);
+            break;
+        case 3:
+            if (processor.getPresetBank().getNumPresets() < PresetBank::maxPresets) {
+                processor.storePreset("Preset");
+            }
+            break;
+        case 4:
+            processor.recallPreset(random.nextInt(juce::jmax(1, processor.getPresetBank().getNumPresets())));
+            break;
+        default:
+            processor.setMeteringEnabled(random.nextBool());
+            processor.getLoadMeter().reset();
+            break;
+    }
+}
+
+//runs one precision for the given time, returns how many blocks went through
+template <typename FloatType>
+static int runUnderChecker(int numChannels, int sampleRate, int blockSize, double seconds) {
+    THICCAudioProcessor processor;
+
+    if (!ToolCommands::setChannelCount(processor, numChannels)) {
+        juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+    }
+
+    processor.setProcessingPrecision(std::is_same<FloatType, double>::value ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    processor.setMeteringEnabled(true);
+
+    AudioThread<FloatType> audioThread(processor, numChannels, blockSize);
+    audioThread.startThread();
+
+    juce::Random random(5678);
+    PeakFrame frames[PeakFrameQueue::capacity];
+    double end = juce::Time::getMillisecondCounterHiRes() + seconds * 1000.0;
+
+    while (juce::Time::getMillisecondCounterHiRes() < end) {
+        changeSomething(processor, random);
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(MESSAGE_INTERVAL);
+
+        //the editor's side of the meters
+        processor.getPeakFrameQueue().pop(frames, PeakFrameQueue::capacity);
+    }
+
+    audioThread.stopThread(1000);
+    processor.releaseResources();
+    return audioThread.numBlocks.load();
+}
+
+//drives the processor from an audio thread while the message thread keeps changing its settings, and fails if
+//processBlock allocates, locks, waits or touches a file
+void ToolCommands::realtime(const juce::ArgumentList& args) {
+    if (!RealtimeChecker::isEnabled) {
+        juce::ConsoleApplication::fail("realtime needs a build with THICC_REALTIME_CHECKS=1, such as the Debug or Test configuration");
+    }
+
+    double seconds = juce::jmax(1, getIntOption(args, "--seconds", 5));
+    int numChannels = juce::jmax(1, getIntOption(args, "--channels", 2));
+    int sampleRate = juce::jmax(8000, getIntOption(args, "--rate", 48000));
+    int blockSize = juce::jmax(16, getIntOption(args, "--block", 512));
+
+    std::cout << "channels: " << numChannels << ", sample rate: " << sampleRate << ", block size: " << blockSize << std::endl;
+    const char* uncaughtCalls = RealtimeChecker::getUncaughtCalls();
+    if (uncaughtCalls != nullptr) {
+        std::cout << "partial coverage, " << uncaughtCalls << " aren't caught in this build" << std::endl;
+    }
+
+    RealtimeChecker::clear();
+
+    int numBlocks = runUnderChecker<float>(numChannels, sampleRate, blockSize, seconds);
+    std::cout << "float: " << numBlocks << " blocks" << std::endl;
+
+    numBlocks = runUnderChecker<double>(numChannels, sampleRate, blockSize, seconds);
+    std::cout << "double: " << numBlocks << " blocks" << std::endl;
+
+    int numViolations = RealtimeChecker::getNumViolations();
+    if (numViolations == 0) {
+        std::cout << (uncaughtCalls != nullptr ? "no violations among the calls caught" : "no violations") << std::endl;
+        return;
+    }
+
+    for (auto& report : RealtimeChecker::getReports()) {
+        std::cout << std::endl << report.call << ", " << report.count << " times, from:" << std::endl << report.stackTrace << std::endl;
+    }
+
+    juce::ConsoleApplication::fail(juce::String(numViolations) + " calls the audio thread must not make");
+}
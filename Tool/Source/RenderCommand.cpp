@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+    RenderCommand.cpp
+    Created: 19 Oct 2026 3:02:51pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+
+#define MESSAGE_INTERVAL 20 //ms the message thread runs between checks on the jobs, so the processors' timers get to run
+
+//one file, opened and closed on the message thread and rendered on the pool
+struct RenderJob {
+    juce::File input;
+    juce::File output;
+    juce::String error; //empty when the file rendered
+    double audioSeconds = 0;
+    double renderSeconds = 0;
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    std::unique_ptr<THICCAudioProcessor> processor;
+    std::atomic<bool> isRendered { false };
+};
+
+//message thread, the way a host builds and prepares a plugin. isNonRealtime lets the processor spread
+//the file's channels over its own worker threads. false with the error set if the file can't be rendered.
+static bool openFile(RenderJob& job, juce::AudioFormatManager& formatManager, const juce::MemoryBlock& state, int blockSize, bool isNonRealtime) {
+    job.reader.reset(formatManager.createReaderFor(job.input));
+    if (job.reader == nullptr) {
+        job.error = "can't read this file";
+        return false;
+    }
+
+    int numChannels = static_cast<int>(job.reader->numChannels);
+    double sampleRate = job.reader->sampleRate;
+
+    job.processor = std::make_unique<THICCAudioProcessor>();
+
+    if (!ToolCommands::setChannelCount(*job.processor, numChannels)) {
+        job.error = "unsupported channel count " + juce::String(numChannels);
+        return false;
+    }
+
+    job.processor->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    job.processor->setNonRealtime(isNonRealtime);
+    job.processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+    job.processor->prepareToPlay(sampleRate, blockSize);
+
+    auto* format = formatManager.findFormatForFileExtension(job.output.getFileExtension());
+    int bitDepth = format->getPossibleBitDepths().contains(static_cast<int>(job.reader->bitsPerSample)) ? static_cast<int>(job.reader->bitsPerSample) : 24;
+
+    job.output.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream(job.output.createOutputStream());
+    if (stream == nullptr) {
+        job.error = "can't write " + job.output.getFullPathName();
+        return false;
+    }
+
+    job.writer.reset(format->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels), bitDepth, job.reader->metadataValues, 0));
+    if (job.writer == nullptr) {
+        job.error = "can't write this format at " + juce::String(numChannels) + " channels, " + juce::String(bitDepth) + " bits";
+        return false;
+    }
+    stream.release(); //the writer owns it now
+    return true;
+}
+
+//message thread, once the file has rendered or failed to open
+static void closeFile(RenderJob& job) {
+    if (job.processor != nullptr) {
+        job.processor->releaseResources();
+    }
+    job.writer.reset();
+    job.reader.reset();
+    job.processor.reset();
+}
+
+//streams one opened file through its processor, on a pool thread. the output is moved back by the
+//reported latency so it lines up with the input, and is the same length.
+static void renderFile(RenderJob& job, int blockSize) {
+    THICCAudioProcessor& processor = *job.processor;
+    int numChannels = static_cast<int>(job.reader->numChannels);
+    juce::int64 length = job.reader->lengthInSamples;
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    juce::int64 readPosition = 0;
+    juce::int64 samplesWritten = 0;
+    juce::int64 samplesToSkip = processor.getLatencySamples();
+
+    juce::int64 start = juce::Time::getHighResolutionTicks();
+
+    //reading past the end gives silence, which flushes the latency out
+    while (samplesWritten < length) {
+        job.reader->read(&buffer, 0, blockSize, readPosition, true, true);
+        readPosition += blockSize;
+
+        processor.processBlock(buffer, midi);
+
+        int skipped = static_cast<int>(juce::jmin(samplesToSkip, static_cast<juce::int64>(blockSize)));
+        samplesToSkip -= skipped;
+
+        int numToWrite = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize - skipped), length - samplesWritten));
+        if (numToWrite > 0 && !job.writer->writeFromAudioSampleBuffer(buffer, skipped, numToWrite)) {
+            job.error = "write failed";
+            return;
+        }
+        samplesWritten += numToWrite;
+    }
+
+    job.audioSeconds = length / job.reader->sampleRate;
+    job.renderSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+}
+
+static void printResult(const RenderJob& job) {
+    std::cout << job.input.getFileName() << ": ";
+    if (job.error.isEmpty()) {
+        std::cout << juce::String(job.audioSeconds, 1) << " s, " << juce::String(job.audioSeconds / job.renderSeconds, 1) << "x realtime" << std::endl;
+    }
+    else {
+        std::cout << job.error << std::endl;
+    }
+}
+
+//the input files from the command line, folders are searched for every format the tool can read
+static juce::Array<juce::File> findInputFiles(const juce::ArgumentList& args, const juce::AudioFormatManager& formatManager) {
+    juce::Array<juce::File> inputs;
+
+    for (int i = 1; i < args.size(); i++) {
+        if (args[i].isOption()) {
+            continue;
+        }
+
+        juce::File file = args[i].resolveAsFile();
+        if (file.isDirectory()) {
+            inputs.addArray(file.findChildFiles(juce::File::findFiles, false, formatManager.getWildcardForAllFormats()));
+        }
+        else if (file.existsAsFile()) {
+            inputs.add(file);
+        }
+        else {
+            juce::ConsoleApplication::fail("No such file: " + file.getFullPathName());
+        }
+    }
+
+    return inputs;
+}
+
+//renders every input through its own processor on a pool of worker threads, one file per job. the processors are
+//built, prepared and freed on the message thread, which keeps running their timers while the pool renders, as a
+//host would. the settings come from a saved state, with --set values applied on top.
+void ToolCommands::render(const juce::ArgumentList& args) {
+    int numThreads = juce::jmax(1, getIntOption(args, "--threads", juce::SystemStats::getNumCpus()));
+    int blockSize = juce::jmax(16, getIntOption(args, "--block", 8192));
+
+    //one processor holds the settings, and its state is what every job loads
+    THICCAudioProcessor settings;
+
+    if (args.containsOption("--state")) {
+        juce::MemoryBlock savedState;
+        if (!args.getExistingFileForOption("--state").loadFileAsData(savedState)) {
+            juce::ConsoleApplication::fail("Can't read the state file");
+        }
+        settings.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    }
+
+    applySetOption(settings, args);
+
+    juce::MemoryBlock state;
+    settings.getStateInformation(state);
+
+    if (args.containsOption("--save-state")) {
+        if (!args.getFileForOption("--save-state").replaceWithData(state.getData(), state.getSize())) {
+            juce::ConsoleApplication::fail("Can't write the state file");
+        }
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    juce::Array<juce::File> inputs = findInputFiles(args, formatManager);
+    if (inputs.isEmpty()) {
+        //saving a state on its own is allowed
+        if (args.containsOption("--save-state")) {
+            return;
+        }
+        juce::ConsoleApplication::fail("No input files");
+    }
+
+    args.failIfOptionIsMissing("--out");
+    juce::File outputFolder = args.getFileForOption("--out");
+    if (!outputFolder.createDirectory()) {
+        juce::ConsoleApplication::fail("Can't create " + outputFolder.getFullPathName());
+    }
+
+    std::vector<RenderJob> jobs(static_cast<size_t>(inputs.size()));
+    juce::StringArray outputPaths;
+
+    for (int i = 0; i < inputs.size(); i++) {
+        RenderJob& job = jobs[static_cast<size_t>(i)];
+        job.input = inputs[i];
+        job.output = outputFolder.getChildFile(inputs[i].getFileName());
+
+        if (job.output == job.input || outputPaths.contains(job.output.getFullPathName())) {
+            juce::ConsoleApplication::fail("Two files would be written to " + job.output.getFullPathName());
+        }
+        outputPaths.add(job.output.getFullPathName());
+    }
+
+    std::cout << "files: " << inputs.size() << ", threads: " << numThreads << ", block size: " << blockSize << std::endl << std::endl;
+
+    //the output is the same either way. when several files render at once the pool already has every core busy,
+    //and each processor starting workers of its own would only oversubscribe them, so they run their channels
+    //in order. a file rendered on its own spreads its channels instead.
+    bool isNonRealtime = juce::jmin(numThreads, inputs.size()) == 1;
+
+    juce::CriticalSection printLock;
+    juce::ThreadPool pool(numThreads);
+    juce::int64 start = juce::Time::getHighResolutionTicks();
+
+    //a file is only opened once a thread is free for it, so no more are open at once than there are threads
+    size_t numOpened = 0;
+    size_t numClosed = 0;
+
+    while (numClosed < jobs.size()) {
+        for (size_t i = numClosed; i < numOpened; i++) {
+            if (jobs[i].isRendered.load() && jobs[i].processor != nullptr) {
+                closeFile(jobs[i]);
+            }
+        }
+        while (numClosed < numOpened && jobs[numClosed].processor == nullptr) {
+            numClosed++;
+        }
+
+        if (numOpened < jobs.size() && pool.getNumJobs() < numThreads) {
+            RenderJob& job = jobs[numOpened++];
+
+            if (!openFile(job, formatManager, state, blockSize, isNonRealtime)) {
+                closeFile(job);
+
+                const juce::ScopedLock lock(printLock);
+                printResult(job);
+                continue;
+            }
+
+            pool.addJob([&job, &printLock, blockSize] {
+                renderFile(job, blockSize);
+
+                {
+                    const juce::ScopedLock lock(printLock);
+                    printResult(job);
+                }
+                job.isRendered.store(true);
+            });
+            continue;
+        }
+
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(MESSAGE_INTERVAL);
+    }
+
+    double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    double audioSeconds = 0;
+    int numFailed = 0;
+    for (auto& job : jobs) {
+        audioSeconds += job.audioSeconds;
+        numFailed += job.error.isNotEmpty() ? 1 : 0;
+    }
+
+    std::cout << std::endl << "rendered " << juce::String(audioSeconds, 1) << " s of audio in " << juce::String(elapsed, 1) << " s, "
+              << juce::String(audioSeconds / elapsed, 1) << "x realtime" << std::endl;
+
+    if (numFailed > 0) {
+        juce::ConsoleApplication::fail(juce::String(numFailed) + " of " + juce::String(inputs.size()) + " files failed");
+    }
+}
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    SuiteCommand.cpp
+    Created: 19 Oct 2026 5:41:09pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+
+static const int blockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+static double toNanoseconds(double seconds, double numSamples) {
+    return seconds * 1.0e9 / numSamples;
+}
+
+//times one processBlock setting, in ns per sample of one channel
+static double timeProcessBlock(int type, bool isClip, bool isEven, const ToolCommands::FilterCase& filters, int factor, int blockSize,
+    int numChannels, int sampleRate, double seconds) {
+    THICCAudioProcessor processor;
+    if (!ToolCommands::setChannelCount(processor, numChannels)) {
+        juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+    }
+
+    ToolCommands::setParameter(processor, "type", static_cast<float>(type));
+    ToolCommands::setParameter(processor, "clip", isClip ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "even", isEven ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "lowPass", filters.lowPass);
+    ToolCommands::setParameter(processor, "highPass", filters.highPass);
+    ToolCommands::setParameter(processor, "multirate", filters.isMultirate ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "OSFactor", static_cast<float>(factor));
+    ToolCommands::setParameter(processor, "drive", 12.0f);
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    int numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+    double elapsed = ToolCommands::renderNoise<float>(processor, numChannels, blockSize, numBlocks);
+
+    processor.releaseResources();
+
+    return toNanoseconds(elapsed, static_cast<double>(numBlocks) * blockSize * numChannels);
+}
+
+//times one curve on its own, SampleType is float or a register of floats
+template <int curve, bool clipPeaks, FastMath::Accuracy accuracy, typename SampleType>
+static double timeShape(const std::vector<SampleType>& input, std::vector<SampleType>& output, int numPasses) {
+    const WaveShaper::Settings settings = WaveShaper::makeSettings(1.0f, 0.0f);
+
+    juce::int64 start = juce::Time::getHighResolutionTicks();
+    for (int pass = 0; pass < numPasses; pass++) {
+        for (size_t i = 0; i < input.size(); i++) {
+            output[i] = WaveShaper::shape<curve, clipPeaks, accuracy>(input[i], settings);
+        }
+    }
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+}
+
+using ScalarShapeTimer = double (*)(const std::vector<float>&, std::vector<float>&, int);
+using RegisterShapeTimer = double (*)(const std::vector<SIMDHelpers::FloatRegister>&, std::vector<SIMDHelpers::FloatRegister>&, int);
+
+struct ShapeCase {
+    int curve;
+    bool clipPeaks;
+    FastMath::Accuracy accuracy;
+    ScalarShapeTimer scalar;
+    RegisterShapeTimer simd;
+};
+
+//index = (curve - 1) * 4 + clipPeaks * 2 + accuracy, packed like the processor's stage table indices
+template <size_t index>
+static ShapeCase makeShapeCase() {
+    constexpr int curve = static_cast<int>(index / 4) + 1;
+    constexpr bool clipPeaks = (index / 2) % 2 == 1;
+    constexpr auto accuracy = static_cast<FastMath::Accuracy>(index % 2);
+
+    return { curve, clipPeaks, accuracy,
+             timeShape<curve, clipPeaks, accuracy, float>,
+             timeShape<curve, clipPeaks, accuracy, SIMDHelpers::FloatRegister> };
+}
+
+template <size_t... indices>
+static std::vector<ShapeCase> makeShapeCases(std::index_sequence<indices...>) {
+    return { makeShapeCase<indices>()... };
+}
+
+//times the oversampler going up and back down with nothing in between, in ns per sample of one channel
+static double timeOversampler(int factor, bool linearPhase, int blockSize, int numChannels, int sampleRate, double seconds) {
+    auto filterType = linearPhase ? juce::dsp::Oversampling<float>::FilterType::filterHalfBandFIREquiripple
+        : juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR;
+
+    juce::dsp::Oversampling<float> oversampler(static_cast<size_t>(numChannels), static_cast<size_t>(factor), filterType, true, true);
+    oversampler.initProcessing(static_cast<size_t>(blockSize));
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::Random random(1234);
+    for (int channel = 0; channel < numChannels; channel++) {
+        for (int sample = 0; sample < blockSize; sample++) {
+            buffer.setSample(channel, sample, random.nextFloat() - 0.5f);
+        }
+    }
+    juce::dsp::AudioBlock<float> block(buffer);
+
+    int numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+
+    juce::int64 start = juce::Time::getHighResolutionTicks();
+    for (int i = 0; i < numBlocks; i++) {
+        oversampler.processSamplesUp(block);
+        oversampler.processSamplesDown(block);
+    }
+    double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    return toNanoseconds(elapsed, static_cast<double>(numBlocks) * blockSize * numChannels);
+}
+
+//runs processBlock over every combination of curve, mode, filters, oversampling and block size, then the
+//curves and the oversampler on their own, and writes ns per sample for each as JSON.
+void ToolCommands::suite(const juce::ArgumentList& args) {
+    double seconds = args.containsOption("--seconds") ? juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue()) : 0.5;
+    int numChannels = juce::jmax(1, getIntOption(args, "--channels", 2));
+    int sampleRate = juce::jmax(8000, getIntOption(args, "--rate", 48000));
+
+    juce::Array<juce::var> processBlockResults;
+
+    for (int type = 1; type <= 4; type++) {
+        for (int isClip = 0; isClip < 2; isClip++) {
+            for (int isEven = 0; isEven < 2; isEven++) {
+                for (auto& filters : ToolCommands::filterCases) {
+                    for (int factor = 1; factor <= 5; factor++) {
+                        for (int blockSize : blockSizes) {
+                            double nanoseconds = timeProcessBlock(type, isClip, isEven, filters, factor, blockSize, numChannels, sampleRate, seconds);
+
+                            juce::DynamicObject::Ptr result = new juce::DynamicObject();
+                            result->setProperty("type", type);
+                            result->setProperty("clip", isClip == 1);
+                            result->setProperty("even", isEven == 1);
+                            result->setProperty("filters", filters.name);
+                            result->setProperty("oversampling", 1 << (factor - 1));
+                            result->setProperty("blockSize", blockSize);
+                            result->setProperty("nsPerSample", nanoseconds);
+                            processBlockResults.add(result.get());
+                        }
+                    }
+                }
+            }
+            std::cerr << "processBlock: curve " << type << (isClip ? " clip" : " saturation") << " done" << std::endl;
+        }
+    }
+
+    //the curves on their own, over a block that fits in cache
+    juce::Array<juce::var> shapeResults;
+    {
+        constexpr int numLanes = static_cast<int>(SIMDHelpers::FloatRegister::size());
+        const int numSamples = 4096;
+        int numPasses = juce::jmax(1, static_cast<int>(seconds * sampleRate / numSamples));
+
+        std::vector<float> input(numSamples), output(numSamples);
+        juce::Random random(1234);
+        for (auto& sample : input) {
+            sample = (random.nextFloat() - 0.5f) * 4.0f; //both sides of the knee
+        }
+
+        std::vector<SIMDHelpers::FloatRegister> registerInput(numSamples / numLanes), registerOutput(numSamples / numLanes);
+        for (size_t i = 0; i < registerInput.size(); i++) {
+            registerInput[i] = SIMDHelpers::FloatRegister::fromRawArray(input.data() + i * numLanes);
+        }
+
+        for (auto& shapeCase : makeShapeCases(std::make_index_sequence<16>())) {
+            double scalarSeconds = shapeCase.scalar(input, output, numPasses);
+            double simdSeconds = shapeCase.simd(registerInput, registerOutput, numPasses);
+
+            juce::DynamicObject::Ptr result = new juce::DynamicObject();
+            result->setProperty("type", shapeCase.curve);
+            result->setProperty("clipPeaks", shapeCase.clipPeaks);
+            result->setProperty("accuracy", shapeCase.accuracy == FastMath::eco ? "eco" : "precise");
+            result->setProperty("scalarNsPerSample", toNanoseconds(scalarSeconds, static_cast<double>(numSamples) * numPasses));
+            result->setProperty("simdNsPerSample", toNanoseconds(simdSeconds, static_cast<double>(numSamples) * numPasses));
+            shapeResults.add(result.get());
+        }
+    }
+
+    juce::Array<juce::var> oversamplerResults;
+    for (int linearPhase = 0; linearPhase < 2; linearPhase++) {
+        for (int factor = 1; factor <= 4; factor++) {
+            for (int blockSize : blockSizes) {
+                juce::DynamicObject::Ptr result = new juce::DynamicObject();
+                result->setProperty("oversampling", 1 << factor);
+                result->setProperty("phase", linearPhase ? "linear" : "iir");
+                result->setProperty("blockSize", blockSize);
+                result->setProperty("nsPerSample", timeOversampler(factor, linearPhase == 1, blockSize, numChannels, sampleRate, seconds));
+                oversamplerResults.add(result.get());
+            }
+        }
+    }
+
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("version", ProjectInfo::versionString);
+    root->setProperty("sampleRate", sampleRate);
+    root->setProperty("channels", numChannels);
+    root->setProperty("secondsPerCase", seconds);
+    root->setProperty("processBlock", processBlockResults);
+    root->setProperty("waveShape", shapeResults);
+    root->setProperty("oversampler", oversamplerResults);
+
+    juce::String json = juce::JSON::toString(juce::var(root.get()));
+
+    if (args.containsOption("--out")) {
+        if (!args.getFileForOption("--out").replaceWithText(json)) {
+            juce::ConsoleApplication::fail("Can't write the results");
+        }
+    }
+    else {
+        std::cout << json << std::endl;
+    }
+}
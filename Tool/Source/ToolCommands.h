@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    ToolCommands.h
+    Created: 18 Oct 2026 11:05:40pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+//each command of the tool gets the arguments after its name, see Main.cpp for the list
+namespace ToolCommands {
+    void measure(const juce::ArgumentList& args);
+    void benchmark(const juce::ArgumentList& args);
+    void render(const juce::ArgumentList& args);
+    void suite(const juce::ArgumentList& args);
+    void aliasing(const juce::ArgumentList& args);
+    void verify(const juce::ArgumentList& args);
+    void realtime(const juce::ArgumentList& args);
+
+    //every setting of the filters the suite and verify commands cover
+    struct FilterCase {
+        const char* name;
+        float lowPass;
+        float highPass;
+        bool isMultirate;
+    };
+
+    inline const FilterCase filterCases[] = {
+        { "off", 20000.0f, 20.0f, false },
+        { "lowPass", 4000.0f, 20.0f, false },
+        { "highPass", 20000.0f, 200.0f, false },
+        { "threeBand", 4000.0f, 200.0f, false },
+        { "threeBandMultirate", 4000.0f, 200.0f, true }, //only the middle band is oversampled
+        { "lowPassMultirate", 4000.0f, 20.0f, true } //only the low band is oversampled
+    };
+
+    //sets a parameter by its id in the units shown on the knob (dB, Hz, %...)
+    inline void setParameter(THICCAudioProcessor& processor, const juce::String& id, float value) {
+        for (auto* parameter : processor.getParameters()) {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter)) {
+                if (ranged->paramID == id) {
+                    ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+                    return;
+                }
+            }
+        }
+        juce::ConsoleApplication::fail("Unknown parameter: " + id);
+    }
+
+    //applies "--set=id=value,id=value..." on top of the processor's current settings
+    inline void applySetOption(THICCAudioProcessor& processor, const juce::ArgumentList& args) {
+        for (auto& assignment : juce::StringArray::fromTokens(args.getValueForOption("--set"), ",", "")) {
+            setParameter(processor, assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                assignment.fromFirstOccurrenceOf("=", false, false).getFloatValue());
+        }
+    }
+
+    //puts the processor's main bus in the default layout for numChannels, false if it isn't supported
+    inline bool setChannelCount(THICCAudioProcessor& processor, int numChannels) {
+        auto layout = processor.getBusesLayout();
+        layout.inputBuses.getReference(0) = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        layout.outputBuses.getReference(0) = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        return processor.setBusesLayout(layout);
+    }
+
+    //renders numBlocks blocks of noise through a prepared processor and returns the seconds spent in processBlock
+    template <typename FloatType>
+    double renderNoise(THICCAudioProcessor& processor, int numChannels, int blockSize, int numBlocks) {
+        juce::AudioBuffer<FloatType> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1234);
+        juce::int64 elapsed = 0;
+
+        for (int block = 0; block < numBlocks; block++) {
+            for (int channel = 0; channel < numChannels; channel++) {
+                FloatType* channelData = buffer.getWritePointer(channel);
+                for (int sample = 0; sample < blockSize; sample++) {
+                    channelData[sample] = static_cast<FloatType>(random.nextFloat() - 0.5f);
+                }
+            }
+
+            //only the processing is timed, not the noise
+            juce::int64 start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            elapsed += juce::Time::getHighResolutionTicks() - start;
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(elapsed);
+    }
+
+    //reads "--name=value", or returns fallback when the option isn't given
+    inline int getIntOption(const juce::ArgumentList& args, const juce::String& name, int fallback) {
+        auto value = args.getValueForOption(name);
+        return value.isEmpty() ? fallback : value.getIntValue();
+    }
+}
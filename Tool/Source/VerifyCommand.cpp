@@ -0,0 +1,435 @@
+/*
+  ==============================================================================
+
+    VerifyCommand.cpp
+    Created: 20 Oct 2026 6:48:02pm
+    Author:  Lys
+
+  ==============================================================================
+*/
+
+#include "ToolCommands.h"
+
+#define VERIFY_SAMPLE_RATE 48000
+#define VERIFY_LENGTH 4096
+#define VERIFY_MAX_BLOCK 512
+#define BASELINE_SAMPLE_RATE 44100 //the first release's dc blockers were tuned for this rate, see --baseline
+
+//uneven block sizes, so anything carried across block boundaries gets exercised
+static const int blockPattern[] = { 512, 1, 37, 256, 129, 512, 3, 64 };
+
+//one combination of the settings that pick a processing path
+struct VerifyCase {
+    int type;
+    bool isClip;
+    bool isEven;
+    bool clipPeaks;
+    const ToolCommands::FilterCase* filters;
+    int factor;
+    bool isAntialiased;
+
+    juce::String getName() const {
+        return "type" + juce::String(type) + (isClip ? "_clip" : "_saturation") + (isEven ? "_even" : "_odd") + (clipPeaks ? "_peaks" : "")
+            + "_" + filters->name + "_" + juce::String(1 << (factor - 1)) + "x" + (isAntialiased ? "_adaa" : "");
+    }
+};
+
+static std::vector<VerifyCase> makeCases() {
+    std::vector<VerifyCase> cases;
+    for (int type = 1; type <= 4; type++) {
+        for (int isClip = 0; isClip < 2; isClip++) {
+            for (int isEven = 0; isEven < 2; isEven++) {
+                for (int clipPeaks = 0; clipPeaks < 2; clipPeaks++) {
+                    for (auto& filters : ToolCommands::filterCases) {
+                        for (int factor = 1; factor <= 5; factor++) {
+                            for (int isAntialiased = 0; isAntialiased < 2; isAntialiased++) {
+                                cases.push_back({ type, isClip == 1, isEven == 1, clipPeaks == 1, &filters, factor, isAntialiased == 1 });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return cases;
+}
+
+//a log sweep from 20 Hz to 20 kHz that rises to +6 dBFS on even channels, seeded noise on odd ones.
+//copyFirstChannel puts the sweep on every channel instead.
+static juce::AudioBuffer<float> makeStimulus(int numChannels, bool copyFirstChannel, double sampleRate) {
+    juce::AudioBuffer<float> stimulus(numChannels, VERIFY_LENGTH);
+    juce::Random random(1234);
+
+    for (int channel = 0; channel < numChannels; channel++) {
+        float* channelData = stimulus.getWritePointer(channel);
+        bool isSweep = copyFirstChannel || channel % 2 == 0;
+
+        double phase = 0;
+        for (int sample = 0; sample < VERIFY_LENGTH; sample++) {
+            double position = static_cast<double>(sample) / VERIFY_LENGTH;
+            if (isSweep) {
+                phase += juce::MathConstants<double>::twoPi * 20.0 * std::pow(1000.0, position) / sampleRate;
+                channelData[sample] = static_cast<float>(2 * position * std::sin(phase));
+            }
+            else {
+                channelData[sample] = (random.nextFloat() - 0.5f) * 1.5f;
+            }
+        }
+    }
+    return stimulus;
+}
+
+//renders the stimulus through a fresh processor with the case's settings. offline (isRealtime false) the channels
+//are spread over the worker pool, in realtime they run in order on the calling thread.
+static juce::AudioBuffer<float> renderCase(const VerifyCase& verifyCase, int numChannels, bool copyFirstChannel, bool isEco, bool isRealtime,
+    double sampleRate = VERIFY_SAMPLE_RATE) {
+    THICCAudioProcessor processor;
+    if (!ToolCommands::setChannelCount(processor, numChannels)) {
+        juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+    }
+
+    ToolCommands::setParameter(processor, "type", static_cast<float>(verifyCase.type));
+    ToolCommands::setParameter(processor, "clip", verifyCase.isClip ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "even", verifyCase.isEven ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "peak", verifyCase.clipPeaks ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "lowPass", verifyCase.filters->lowPass);
+    ToolCommands::setParameter(processor, "highPass", verifyCase.filters->highPass);
+    ToolCommands::setParameter(processor, "multirate", verifyCase.filters->isMultirate ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "OSFactor", static_cast<float>(verifyCase.factor));
+    ToolCommands::setParameter(processor, "antialiasing", verifyCase.isAntialiased ? 1.0f : 0.0f);
+    ToolCommands::setParameter(processor, "eco", isEco ? 1.0f : 0.0f);
+
+    //off the defaults, so every part of the curves is in use
+    ToolCommands::setParameter(processor, "drive", 9.0f);
+    ToolCommands::setParameter(processor, "knee", 30.0f);
+    ToolCommands::setParameter(processor, "softness", 80.0f);
+    ToolCommands::setParameter(processor, "mix", 70.0f);
+
+    processor.setNonRealtime(!isRealtime);
+    processor.setRateAndBufferSizeDetails(sampleRate, VERIFY_MAX_BLOCK);
+    processor.prepareToPlay(sampleRate, VERIFY_MAX_BLOCK);
+
+    juce::AudioBuffer<float> output = makeStimulus(numChannels, copyFirstChannel, sampleRate);
+    juce::MidiBuffer midi;
+
+    int position = 0;
+    for (int block = 0; position < VERIFY_LENGTH; block++) {
+        int blockSize = juce::jmin(blockPattern[block % juce::numElementsInArray(blockPattern)], VERIFY_LENGTH - position);
+        juce::AudioBuffer<float> blockBuffer(output.getArrayOfWritePointers(), numChannels, position, blockSize);
+        processor.processBlock(blockBuffer, midi);
+        position += blockSize;
+    }
+
+    processor.releaseResources();
+    return output;
+}
+
+//the largest difference between two renders in dBFS, -inf when they are identical
+static double getDifference(const juce::AudioBuffer<float>& a, int channelA, const juce::AudioBuffer<float>& b, int channelB) {
+    float maxDifference = 0;
+    const float* dataA = a.getReadPointer(channelA);
+    const float* dataB = b.getReadPointer(channelB);
+
+    for (int sample = 0; sample < juce::jmin(a.getNumSamples(), b.getNumSamples()); sample++) {
+        float difference = std::abs(dataA[sample] - dataB[sample]);
+        //a NaN on either side is always a failure
+        maxDifference = std::isnan(difference) ? std::numeric_limits<float>::infinity() : juce::jmax(maxDifference, difference);
+    }
+    return juce::Decibels::gainToDecibels(static_cast<double>(maxDifference), -std::numeric_limits<double>::infinity());
+}
+
+//the curves as they were before they were specialized and approximated, one runtime branch per setting, in double
+static double referenceShape(double sampleData, int type, double softness, double knee, bool clipPeaks) {
+    double waveShapedData = std::abs(sampleData);
+
+    switch (type) {
+        case 1:
+            if (clipPeaks && waveShapedData >= std::asin(1 - knee) + knee) {
+                waveShapedData = 1;
+            }
+            else if (waveShapedData > knee) {
+                waveShapedData = std::sin(waveShapedData - knee) + knee;
+            }
+            break;
+        case 2:
+            if (waveShapedData > knee) {
+                waveShapedData = -std::exp(knee - waveShapedData) + knee + 1;
+            }
+            break;
+        case 3:
+            if (waveShapedData > knee) {
+                waveShapedData = std::log(waveShapedData - knee + 1) + knee;
+            }
+            break;
+        default:
+            if (waveShapedData > knee) {
+                waveShapedData = std::tanh(waveShapedData - knee) + knee;
+            }
+    }
+
+    if (clipPeaks) {
+        waveShapedData = std::fmin(waveShapedData, 1.0);
+    }
+    waveShapedData = softness * waveShapedData + (1 - softness) * std::fmin(std::abs(sampleData), 1.0);
+
+    return sampleData > 0 ? waveShapedData : -waveShapedData;
+}
+
+//largest error of one specialized kernel against the reference, over both sides of the knee. the SIMD version has to
+//match the scalar one exactly, any difference is returned as infinity.
+template <int curve, bool clipPeaks, FastMath::Accuracy accuracy>
+static double getKernelError(float softness, float knee) {
+    using Register = SIMDHelpers::FloatRegister;
+    const WaveShaper::Settings settings = WaveShaper::makeSettings(softness, knee);
+    const int numLanes = static_cast<int>(Register::size());
+    const int numSamples = 8192;
+
+    alignas(Register::SIMDRegisterSize) float inputs[Register::size()];
+    alignas(Register::SIMDRegisterSize) float outputs[Register::size()];
+    double maxError = 0;
+
+    for (int first = 0; first < numSamples; first += numLanes) {
+        for (int lane = 0; lane < numLanes; lane++) {
+            inputs[lane] = 8.0f * static_cast<float>(first + lane - numSamples / 2) / (numSamples / 2);
+        }
+
+        WaveShaper::shape<curve, clipPeaks, accuracy>(Register::fromRawArray(inputs), settings).copyToRawArray(outputs);
+
+        for (int lane = 0; lane < numLanes; lane++) {
+            float scalar = WaveShaper::shape<curve, clipPeaks, accuracy>(inputs[lane], settings);
+            if (scalar != outputs[lane]) {
+                return std::numeric_limits<double>::infinity();
+            }
+            maxError = juce::jmax(maxError, std::abs(scalar - referenceShape(inputs[lane], curve, softness, knee, clipPeaks)));
+        }
+    }
+    return maxError;
+}
+
+using KernelErrorFunction = double (*)(float, float);
+
+struct KernelCase {
+    int curve;
+    bool clipPeaks;
+    FastMath::Accuracy accuracy;
+    KernelErrorFunction getError;
+};
+
+//index = (curve - 1) * 4 + clipPeaks * 2 + accuracy, as in the suite command
+template <size_t index>
+static KernelCase makeKernelCase() {
+    constexpr int curve = static_cast<int>(index / 4) + 1;
+    constexpr bool clipPeaks = (index / 2) % 2 == 1;
+    constexpr auto accuracy = static_cast<FastMath::Accuracy>(index % 2);
+    return { curve, clipPeaks, accuracy, getKernelError<curve, clipPeaks, accuracy> };
+}
+
+template <size_t... indices>
+static std::vector<KernelCase> makeKernelCases(std::index_sequence<indices...>) {
+    return { makeKernelCase<indices>()... };
+}
+
+//reads a stereo reference of VERIFY_LENGTH samples, false if it's missing or the wrong shape
+static bool readReference(juce::AudioFormatManager& formatManager, const juce::File& file, juce::AudioBuffer<float>& reference) {
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->numChannels != 2 || reader->lengthInSamples != VERIFY_LENGTH) {
+        return false;
+    }
+
+    reference.setSize(2, VERIFY_LENGTH);
+    return reader->read(&reference, 0, VERIFY_LENGTH, 0, true, true);
+}
+
+//counts and prints failures, only the first few of each check are printed
+struct FailureLog {
+    int numFailed = 0;
+
+    void add(const juce::String& check, const juce::String& name, double difference, double tolerance) {
+        if (++numFailed <= 20) {
+            std::cout << "  FAIL " << check << " " << name << ": " << juce::String(difference, 1) << " dB (tolerance " << juce::String(tolerance, 1) << " dB)" << std::endl;
+        }
+    }
+};
+
+//golden renders of every processing path, realtime and offline, compared against references written by a known good
+//build, the 1x renders against the first release's, then null tests of the fast paths against their references:
+//  - every channel of a SIMD group against the same signal through the single channel path
+//  - eco curves against precise ones
+//  - the specialized curve kernels, scalar and SIMD, against the original unspecialized curves
+void ToolCommands::verify(const juce::ArgumentList& args) {
+    double tolerance = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getDoubleValue() : -100.0;
+    double baselineTolerance = -100.0;
+    double ecoTolerance = -60.0;
+    double preciseKernelTolerance = 1.0e-6;
+    double ecoKernelTolerance = 2.0e-4;
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::vector<VerifyCase> cases = makeCases();
+    FailureLog failures;
+
+    if (args.containsOption("--write")) {
+        juce::File folder = args.getFileForOption("--write");
+        if (!folder.createDirectory()) {
+            juce::ConsoleApplication::fail("Can't create " + folder.getFullPathName());
+        }
+
+        for (auto& verifyCase : cases) {
+            juce::AudioBuffer<float> output = renderCase(verifyCase, 2, false, false, false);
+            juce::File file = folder.getChildFile(verifyCase.getName() + ".wav");
+
+            file.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+            if (stream != nullptr) {
+                writer.reset(formatManager.findFormatForFileExtension("wav")->createWriterFor(stream.get(), VERIFY_SAMPLE_RATE, 2, 32, {}, 0));
+            }
+            if (writer == nullptr) {
+                juce::ConsoleApplication::fail("Can't write " + file.getFullPathName());
+            }
+            stream.release(); //the writer owns it now
+
+            writer->writeFromAudioSampleBuffer(output, 0, output.getNumSamples());
+        }
+
+        std::cout << "wrote " << cases.size() << " references to " << folder.getFullPathName() << std::endl;
+        return;
+    }
+
+    if (args.containsOption("--against")) {
+        juce::File folder = args.getExistingFolderForOption("--against");
+        std::cout << "golden renders, tolerance " << juce::String(tolerance, 1) << " dBFS" << std::endl;
+
+        double worst = -std::numeric_limits<double>::infinity();
+        for (auto& verifyCase : cases) {
+            juce::AudioBuffer<float> reference;
+            if (!readReference(formatManager, folder.getChildFile(verifyCase.getName() + ".wav"), reference)) {
+                failures.add("golden", verifyCase.getName(), std::numeric_limits<double>::infinity(), tolerance);
+                continue;
+            }
+
+            //hosts play in realtime and bounce offline, both have to match the same reference
+            for (int isRealtime = 0; isRealtime < 2; isRealtime++) {
+                juce::AudioBuffer<float> output = renderCase(verifyCase, 2, false, false, isRealtime == 1);
+
+                for (int channel = 0; channel < 2; channel++) {
+                    double difference = getDifference(output, channel, reference, channel);
+                    worst = juce::jmax(worst, difference);
+                    if (difference > tolerance) {
+                        failures.add("golden", verifyCase.getName() + (isRealtime == 1 ? " realtime" : " offline") + " channel " + juce::String(channel), difference, tolerance);
+                    }
+                }
+            }
+        }
+        std::cout << "  " << cases.size() << " cases, realtime and offline, largest difference " << juce::String(worst, 1) << " dBFS" << std::endl;
+    }
+
+    //the oversampling filters come from JUCE and the first release had no multirate split, antialiasing or eco,
+    //so only the 1x renders of the paths it had are held to its output
+    if (args.containsOption("--baseline")) {
+        juce::File folder = args.getExistingFolderForOption("--baseline");
+        std::cout << "1x renders against the first release at " << BASELINE_SAMPLE_RATE << " Hz, tolerance " << juce::String(baselineTolerance, 1) << " dBFS" << std::endl;
+
+        double worst = -std::numeric_limits<double>::infinity();
+        int numCases = 0;
+        for (auto& verifyCase : cases) {
+            if (verifyCase.factor != 1 || verifyCase.isAntialiased || verifyCase.filters->isMultirate) {
+                continue;
+            }
+            numCases++;
+
+            juce::AudioBuffer<float> reference;
+            if (!readReference(formatManager, folder.getChildFile(verifyCase.getName() + ".wav"), reference)) {
+                failures.add("baseline", verifyCase.getName(), std::numeric_limits<double>::infinity(), baselineTolerance);
+                continue;
+            }
+
+            for (int isRealtime = 0; isRealtime < 2; isRealtime++) {
+                juce::AudioBuffer<float> output = renderCase(verifyCase, 2, false, false, isRealtime == 1, BASELINE_SAMPLE_RATE);
+
+                for (int channel = 0; channel < 2; channel++) {
+                    double difference = getDifference(output, channel, reference, channel);
+                    worst = juce::jmax(worst, difference);
+                    if (difference > baselineTolerance) {
+                        failures.add("baseline", verifyCase.getName() + (isRealtime == 1 ? " realtime" : " offline") + " channel " + juce::String(channel), difference, baselineTolerance);
+                    }
+                }
+            }
+        }
+        std::cout << "  " << numCases << " cases, realtime and offline, largest difference " << juce::String(worst, 1) << " dBFS" << std::endl;
+    }
+
+    //a full group of lanes plus one left over, so both the SIMD and the single channel paths run
+    int numGroupChannels = static_cast<int>(SIMDHelpers::FloatRegister::size()) + 1;
+    std::cout << "SIMD against single channel, " << numGroupChannels << " channels, tolerance " << juce::String(tolerance, 1) << " dBFS" << std::endl;
+    {
+        double worst = -std::numeric_limits<double>::infinity();
+        for (auto& verifyCase : cases) {
+            juce::AudioBuffer<float> single = renderCase(verifyCase, 1, true, false, true);
+            juce::AudioBuffer<float> group = renderCase(verifyCase, numGroupChannels, true, false, true);
+
+            for (int channel = 0; channel < numGroupChannels; channel++) {
+                double difference = getDifference(group, channel, single, 0);
+                worst = juce::jmax(worst, difference);
+                if (difference > tolerance) {
+                    failures.add("simd", verifyCase.getName() + " channel " + juce::String(channel), difference, tolerance);
+                }
+            }
+        }
+        std::cout << "  " << cases.size() << " cases, largest difference " << juce::String(worst, 1) << " dBFS" << std::endl;
+    }
+
+    //antialiased curves are always precise, so those cases are skipped
+    std::cout << "eco against precise, tolerance " << juce::String(ecoTolerance, 1) << " dBFS" << std::endl;
+    {
+        double worst = -std::numeric_limits<double>::infinity();
+        int numCases = 0;
+        for (auto& verifyCase : cases) {
+            if (verifyCase.isAntialiased) {
+                continue;
+            }
+            numCases++;
+
+            juce::AudioBuffer<float> precise = renderCase(verifyCase, 2, false, false, true);
+            juce::AudioBuffer<float> eco = renderCase(verifyCase, 2, false, true, true);
+
+            for (int channel = 0; channel < 2; channel++) {
+                double difference = getDifference(eco, channel, precise, channel);
+                worst = juce::jmax(worst, difference);
+                if (difference > ecoTolerance) {
+                    failures.add("eco", verifyCase.getName() + " channel " + juce::String(channel), difference, ecoTolerance);
+                }
+            }
+        }
+        std::cout << "  " << numCases << " cases, largest difference " << juce::String(worst, 1) << " dBFS" << std::endl;
+    }
+
+    std::cout << "curve kernels against the reference curves, tolerance " << preciseKernelTolerance << " precise, " << ecoKernelTolerance << " eco" << std::endl;
+    {
+        const float settings[][2] = { { 1.0f, 0.0f }, { 0.8f, 0.3f }, { 1.0f, 0.7f }, { 0.5f, 1.0f } }; //softness, knee
+        double worst = 0;
+        int numCases = 0;
+
+        for (auto& kernelCase : makeKernelCases(std::make_index_sequence<16>())) {
+            double kernelTolerance = kernelCase.accuracy == FastMath::eco ? ecoKernelTolerance : preciseKernelTolerance;
+
+            for (auto& setting : settings) {
+                numCases++;
+                double error = kernelCase.getError(setting[0], setting[1]);
+                worst = juce::jmax(worst, error);
+                if (error > kernelTolerance) {
+                    juce::String name = "type" + juce::String(kernelCase.curve) + (kernelCase.clipPeaks ? "_peaks" : "") + (kernelCase.accuracy == FastMath::eco ? "_eco" : "")
+                        + " softness " + juce::String(setting[0]) + " knee " + juce::String(setting[1]);
+                    failures.add("kernel", name, juce::Decibels::gainToDecibels(error, -200.0), juce::Decibels::gainToDecibels(kernelTolerance));
+                }
+            }
+        }
+        std::cout << "  " << numCases << " cases, largest error " << worst << std::endl;
+    }
+
+    if (failures.numFailed > 0) {
+        juce::ConsoleApplication::fail(juce::String(failures.numFailed) + " checks failed");
+    }
+    std::cout << "all checks passed" << std::endl;
+}